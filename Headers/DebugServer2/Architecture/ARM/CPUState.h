@@ -138,6 +138,35 @@ public:
     }
   }
 
+public:
+  //
+  // Returns the register set holding a register pointer obtained from
+  // getLLDBRegisterPtr or getGDBRegisterPtr.
+  //
+  inline uint32_t getRegisterSet(void const *ptr) const {
+    if (IsRegisterPtrWithin(ptr, gp))
+      return kRegisterSetGP;
+    if (IsRegisterPtrWithin(ptr, hbp))
+      return kRegisterSetDebug;
+    return kRegisterSetFP;
+  }
+
+  //
+  // Copies the registers of the given sets from another CPU state, leaving
+  // the other sets untouched.
+  //
+  inline void copyRegisterSets(CPUState const &other, uint32_t sets) {
+    if (sets & kRegisterSetGP) {
+      gp = other.gp;
+    }
+    if (sets & kRegisterSetFP) {
+      vfp = other.vfp;
+    }
+    if (sets & kRegisterSetDebug) {
+      hbp = other.hbp;
+    }
+  }
+
 public:
   inline bool getLLDBRegisterPtr(int regno, void **ptr, size_t *length) const {
     if (regno >= reg_lldb_r0 && regno <= reg_lldb_r15) {
@@ -75,6 +75,28 @@ enum LLDBVectorFormat {
 
 enum /*RegisterDefFlags*/ { kRegisterDefNoGDBRegisterNumber = (1 << 0) };
 
+//
+// Groups of registers that are transferred to and from the inferior as a
+// whole; a CPU state only needs the sets that are actually accessed.
+//
+enum /*RegisterSet*/ {
+  kRegisterSetGP = (1 << 0),
+  kRegisterSetFP = (1 << 1),
+  kRegisterSetDebug = (1 << 2),
+  kRegisterSetAll = kRegisterSetGP | kRegisterSetFP | kRegisterSetDebug
+};
+
+//
+// Whether a register pointer obtained from a CPU state lies within the
+// given member of that CPU state.
+//
+template <typename T>
+inline bool IsRegisterPtrWithin(void const *ptr, T const &member) {
+  char const *p = static_cast<char const *>(ptr);
+  char const *begin = reinterpret_cast<char const *>(&member);
+  return p >= begin && p < begin + sizeof(member);
+}
+
 struct RegisterDef {
   char const *Name;
   char const *LLDBName;
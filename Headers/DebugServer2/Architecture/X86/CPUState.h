@@ -217,6 +217,44 @@ public:
   }
 #undef _REGVALUE
 
+public:
+  //
+  // Returns the register set holding a register pointer obtained from
+  // getLLDBRegisterPtr or getGDBRegisterPtr.
+  //
+  inline uint32_t getRegisterSet(void const *ptr) const {
+    if (IsRegisterPtrWithin(ptr, gp))
+      return kRegisterSetGP;
+#if defined(__linux__)
+    if (IsRegisterPtrWithin(ptr, linux_gp))
+      return kRegisterSetGP;
+#endif
+    if (IsRegisterPtrWithin(ptr, dr))
+      return kRegisterSetDebug;
+    return kRegisterSetFP;
+  }
+
+  //
+  // Copies the registers of the given sets from another CPU state, leaving
+  // the other sets untouched.
+  //
+  inline void copyRegisterSets(CPUState const &other, uint32_t sets) {
+    if (sets & kRegisterSetGP) {
+      gp = other.gp;
+#if defined(__linux__)
+      linux_gp = other.linux_gp;
+#endif
+    }
+    if (sets & kRegisterSetFP) {
+      x87 = other.x87;
+      static_assert(sizeof(avx) == sizeof(sse), "AVX must overlay SSE");
+      std::memcpy(&avx, &other.avx, sizeof(avx));
+    }
+    if (sets & kRegisterSetDebug) {
+      dr = other.dr;
+    }
+  }
+
 public:
   inline bool getLLDBRegisterPtr(int regno, void **ptr, size_t *length) const {
 #define _GETREG2(T, REG, FLD)                                                  \
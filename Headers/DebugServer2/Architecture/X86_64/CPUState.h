@@ -106,9 +106,9 @@ struct CPUState64 {
           SSEVector _sse[128];
         };
         SSEVector const &operator[](size_t index) const {
-          return _sse[index << 1];
+          return _sse[index << 2];
         }
-        SSEVector &operator[](size_t index) { return _sse[index << 1]; }
+        SSEVector &operator[](size_t index) { return _sse[index << 2]; }
       } regs;
     } sse;
 
@@ -135,6 +135,16 @@ struct CPUState64 {
     } eavx;
   };
 
+  struct {
+    uint64_t regs[8];
+  } kmask;
+
+  //
+  // State components enabled in XCR0, as reported by the kernel in the
+  // XSAVE area. Zero when the vector state was not read through XSAVE.
+  //
+  uint64_t xcr0;
+
   struct {
     uint32_t dr[8];
   } dr;
@@ -154,6 +164,8 @@ public:
     std::memset(&gp, 0, sizeof(gp));
     std::memset(&x87, 0, sizeof(x87));
     std::memset(&eavx, 0, sizeof(eavx));
+    std::memset(&kmask, 0, sizeof(kmask));
+    xcr0 = 0;
     std::memset(&dr, 0, sizeof(dr));
 #if defined(__linux__)
     std::memset(&linux_gp, 0, sizeof(linux_gp));
@@ -300,6 +312,47 @@ public:
   }
 #undef _REGVALUE
 
+public:
+  //
+  // Returns the register set holding a register pointer obtained from
+  // getLLDBRegisterPtr or getGDBRegisterPtr.
+  //
+  inline uint32_t getRegisterSet(void const *ptr) const {
+    if (IsRegisterPtrWithin(ptr, gp))
+      return kRegisterSetGP;
+#if defined(__linux__)
+    if (IsRegisterPtrWithin(ptr, linux_gp))
+      return kRegisterSetGP;
+#endif
+    if (IsRegisterPtrWithin(ptr, dr))
+      return kRegisterSetDebug;
+    return kRegisterSetFP;
+  }
+
+  //
+  // Copies the registers of the given sets from another CPU state, leaving
+  // the other sets untouched.
+  //
+  inline void copyRegisterSets(CPUState64 const &other, uint32_t sets) {
+    if (sets & kRegisterSetGP) {
+      gp = other.gp;
+#if defined(__linux__)
+      linux_gp = other.linux_gp;
+#endif
+    }
+    if (sets & kRegisterSetFP) {
+      x87 = other.x87;
+      static_assert(sizeof(eavx) == sizeof(sse) && sizeof(eavx) == sizeof(avx),
+                    "EAVX must overlay SSE and AVX");
+      std::memcpy(&eavx, &other.eavx, sizeof(eavx));
+      kmask = other.kmask;
+      xcr0 = other.xcr0;
+    }
+    if (sets & kRegisterSetDebug) {
+      dr = other.dr;
+    }
+  }
+
 public:
   inline bool getLLDBRegisterPtr(int regno, void **ptr, size_t *length) const {
 #define _GETREG2(T, REG, FLD)                                                  \
@@ -434,6 +487,48 @@ public:
       _GETREG2(avx, ymm14, regs[14]);
       _GETREG2(avx, ymm15, regs[15]);
 
+      _GETREG2(eavx, zmm0, regs[0]);
+      _GETREG2(eavx, zmm1, regs[1]);
+      _GETREG2(eavx, zmm2, regs[2]);
+      _GETREG2(eavx, zmm3, regs[3]);
+      _GETREG2(eavx, zmm4, regs[4]);
+      _GETREG2(eavx, zmm5, regs[5]);
+      _GETREG2(eavx, zmm6, regs[6]);
+      _GETREG2(eavx, zmm7, regs[7]);
+      _GETREG2(eavx, zmm8, regs[8]);
+      _GETREG2(eavx, zmm9, regs[9]);
+      _GETREG2(eavx, zmm10, regs[10]);
+      _GETREG2(eavx, zmm11, regs[11]);
+      _GETREG2(eavx, zmm12, regs[12]);
+      _GETREG2(eavx, zmm13, regs[13]);
+      _GETREG2(eavx, zmm14, regs[14]);
+      _GETREG2(eavx, zmm15, regs[15]);
+      _GETREG2(eavx, zmm16, regs[16]);
+      _GETREG2(eavx, zmm17, regs[17]);
+      _GETREG2(eavx, zmm18, regs[18]);
+      _GETREG2(eavx, zmm19, regs[19]);
+      _GETREG2(eavx, zmm20, regs[20]);
+      _GETREG2(eavx, zmm21, regs[21]);
+      _GETREG2(eavx, zmm22, regs[22]);
+      _GETREG2(eavx, zmm23, regs[23]);
+      _GETREG2(eavx, zmm24, regs[24]);
+      _GETREG2(eavx, zmm25, regs[25]);
+      _GETREG2(eavx, zmm26, regs[26]);
+      _GETREG2(eavx, zmm27, regs[27]);
+      _GETREG2(eavx, zmm28, regs[28]);
+      _GETREG2(eavx, zmm29, regs[29]);
+      _GETREG2(eavx, zmm30, regs[30]);
+      _GETREG2(eavx, zmm31, regs[31]);
+
+      _GETREG2(kmask, k0, regs[0]);
+      _GETREG2(kmask, k1, regs[1]);
+      _GETREG2(kmask, k2, regs[2]);
+      _GETREG2(kmask, k3, regs[3]);
+      _GETREG2(kmask, k4, regs[4]);
+      _GETREG2(kmask, k5, regs[5]);
+      _GETREG2(kmask, k6, regs[6]);
+      _GETREG2(kmask, k7, regs[7]);
+
     default:
       return false;
     }
@@ -598,6 +693,25 @@ public:
     }
   }
 
+public:
+  inline uint32_t getRegisterSet(void const *ptr) const {
+    if (is32) {
+      return state32.getRegisterSet(ptr);
+    } else {
+      return state64.getRegisterSet(ptr);
+    }
+  }
+
+  inline void copyRegisterSets(CPUState const &other, uint32_t sets) {
+    if (is32 != other.is32) {
+      *this = other;
+    } else if (is32) {
+      state32.copyRegisterSets(other.state32, sets);
+    } else {
+      state64.copyRegisterSets(other.state64, sets);
+    }
+  }
+
 public:
   inline bool getLLDBRegisterPtr(int regno, void **ptr, size_t *length) const {
     if (is32) {
@@ -77,6 +77,14 @@ enum /* dwarf_reg */ {
   reg_dwarf_xmm13 = 30,
   reg_dwarf_xmm14 = 31,
   reg_dwarf_xmm15 = 32,
+  reg_dwarf_k0 = 118,
+  reg_dwarf_k1 = 119,
+  reg_dwarf_k2 = 120,
+  reg_dwarf_k3 = 121,
+  reg_dwarf_k4 = 122,
+  reg_dwarf_k5 = 123,
+  reg_dwarf_k6 = 124,
+  reg_dwarf_k7 = 125,
 };
 
 enum /* gdb_reg */ {
@@ -329,6 +337,46 @@ enum /* lldb_reg */ {
   reg_lldb_xmm13 = 123,
   reg_lldb_xmm14 = 124,
   reg_lldb_xmm15 = 125,
+  reg_lldb_zmm0 = 126,
+  reg_lldb_zmm1 = 127,
+  reg_lldb_zmm2 = 128,
+  reg_lldb_zmm3 = 129,
+  reg_lldb_zmm4 = 130,
+  reg_lldb_zmm5 = 131,
+  reg_lldb_zmm6 = 132,
+  reg_lldb_zmm7 = 133,
+  reg_lldb_zmm8 = 134,
+  reg_lldb_zmm9 = 135,
+  reg_lldb_zmm10 = 136,
+  reg_lldb_zmm11 = 137,
+  reg_lldb_zmm12 = 138,
+  reg_lldb_zmm13 = 139,
+  reg_lldb_zmm14 = 140,
+  reg_lldb_zmm15 = 141,
+  reg_lldb_zmm16 = 142,
+  reg_lldb_zmm17 = 143,
+  reg_lldb_zmm18 = 144,
+  reg_lldb_zmm19 = 145,
+  reg_lldb_zmm20 = 146,
+  reg_lldb_zmm21 = 147,
+  reg_lldb_zmm22 = 148,
+  reg_lldb_zmm23 = 149,
+  reg_lldb_zmm24 = 150,
+  reg_lldb_zmm25 = 151,
+  reg_lldb_zmm26 = 152,
+  reg_lldb_zmm27 = 153,
+  reg_lldb_zmm28 = 154,
+  reg_lldb_zmm29 = 155,
+  reg_lldb_zmm30 = 156,
+  reg_lldb_zmm31 = 157,
+  reg_lldb_k0 = 158,
+  reg_lldb_k1 = 159,
+  reg_lldb_k2 = 160,
+  reg_lldb_k3 = 161,
+  reg_lldb_k4 = 162,
+  reg_lldb_k5 = 163,
+  reg_lldb_k6 = 164,
+  reg_lldb_k7 = 165,
 };
 
 extern LLDBDescriptor const LLDB;
@@ -21,6 +21,7 @@ public:
     kTypePermanent = (1 << 0),
     kTypeTemporaryOneShot = (1 << 1),
     kTypeTemporaryUntilHit = (1 << 2),
+    kTypeInternal = (1 << 3),
   };
 
 public:
@@ -60,8 +61,13 @@ public:
   virtual ErrorCode add(Address const &address, Type type, size_t size);
   virtual ErrorCode remove(Address const &address);
 
+public:
+  ErrorCode addInternal(Address const &address);
+  ErrorCode removeInternal(Address const &address);
+
 public:
   virtual bool has(Address const &address) const;
+  bool isInternal(Address const &address) const;
 
 public:
   virtual void enumerate(std::function<void(Site const &)> const &cb) const;
@@ -77,6 +77,8 @@ struct ByteCodeVMDelegate {
   virtual bool readMemory16(Address const &address, uint16_t &result) = 0;
   virtual bool readMemory32(Address const &address, uint32_t &result) = 0;
   virtual bool readMemory64(Address const &address, uint64_t &result) = 0;
+  virtual bool readString(Address const &address, size_t length,
+                          std::string &result) = 0;
   virtual bool readRegister(size_t index, uint64_t &result) = 0;
   virtual bool readTraceStateVariable(size_t index, uint64_t &result) = 0;
   virtual bool writeTraceStateVariable(size_t index, uint64_t result) = 0;
@@ -16,6 +16,20 @@
 namespace ds2 {
 namespace GDBRemote {
 
+//
+// Default maximum size of the packets we exchange, as advertised in
+// qSupported. LLDB copes with much larger packets, which cuts the number of
+// round trips of bulk transfers.
+//
+static size_t const kDefaultPacketSize = 0x3fff;
+static size_t const kLLDBPacketSize = 0x20000;
+
+//
+// Smallest packet size a client may ask for; replies that are trimmed to the
+// packet size need some room left once their headers are accounted for.
+//
+static size_t const kMinimumPacketSize = 0x100;
+
 enum CompatibilityMode {
   kCompatibilityModeGDB,
   kCompatibilityModeGDBMultiprocess,
@@ -35,6 +35,11 @@ protected:
   Session *_resumeSession;
   std::string _consoleBuffer;
 
+protected:
+  std::string _memoryMapXML;
+  std::string _memoryRegionsJSON;
+  std::string _sharedLibrariesXML;
+
 public:
   DebugSessionImpl(StringCollection const &args, EnvironmentBlock const &env);
   DebugSessionImpl(int attachPid);
@@ -70,7 +75,10 @@ protected:
                                           bool list, StopCode &stop);
 
   virtual ErrorCode onQueryThreadList(Session &session, ProcessId pid,
-                                      ThreadId lastTid, ThreadId &tid);
+                                      ThreadId lastTid, size_t count,
+                                      std::vector<ThreadId> &tids);
+  virtual ErrorCode onQueryThreadsInfo(Session &session, ProcessId pid,
+                                       std::string &buffer);
 
 protected:
   virtual ErrorCode onQueryRegisterInfo(Session &session, uint32_t regno,
@@ -86,6 +94,10 @@ protected:
                                uint64_t length, std::string &buffer,
                                bool &last);
 
+protected:
+  ErrorCode generateMemoryMap(bool json, std::string &buffer);
+  void invalidateMemoryMap();
+
 protected:
   virtual ErrorCode
   onReadGeneralRegisters(Session &session, ProcessThreadId const &ptid,
@@ -111,6 +123,8 @@ protected:
 protected:
   virtual ErrorCode onReadMemory(Session &session, Address const &address,
                                  size_t length, std::string &data);
+  virtual ErrorCode onReadMemory(Session &session,
+                                 MemoryRange::Collection &ranges);
   virtual ErrorCode onWriteMemory(Session &session, Address const &address,
                                   std::string const &data, size_t &nwritten);
 
@@ -118,6 +132,19 @@ protected:
                                      uint32_t permissions, Address &address);
   virtual ErrorCode onDeallocateMemory(Session &session,
                                        Address const &address);
+  virtual ErrorCode onQueryMemoryRegionInfo(Session &session,
+                                            Address const &address,
+                                            MemoryRegionInfo &info);
+
+  virtual ErrorCode onComputeCRC(Session &session, Address const &address,
+                                 size_t length, uint32_t &crc);
+
+  virtual ErrorCode onSearch(Session &session, Address const &address,
+                             size_t length, std::string const &pattern,
+                             Address &location);
+  virtual ErrorCode onSearchBackward(Session &session, Address const &address,
+                                     uint32_t pattern, uint32_t mask,
+                                     Address &location);
 
 protected:
   virtual ErrorCode onSetProgramArguments(Session &session,
@@ -149,6 +176,12 @@ protected:
   Target::Thread *findThread(ProcessThreadId const &ptid) const;
   ErrorCode queryStopCode(Session &session, ProcessThreadId const &ptid,
                           StopCode &stop) const;
+  ErrorCode queryThreadStopCode(Session &session, Target::Thread *thread,
+                                bool expedite, StopCode &stop) const;
+  void generateThreadsInfo(Session &session, bool expedite,
+                           std::string &buffer) const;
+  ErrorCode resumeAfterInternalStop(std::set<ThreadId> const &held,
+                                    Target::Thread *&pending);
 
 private:
   ErrorCode spawnProcess(StringCollection const &args,
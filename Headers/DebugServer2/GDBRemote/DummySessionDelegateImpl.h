@@ -31,9 +31,6 @@ protected: // Common
   virtual ErrorCode onSetBaudRate(Session &session, uint32_t speed);
   virtual ErrorCode onToggleDebugFlag(Session &session);
 
-  virtual ErrorCode onSetMaxPacketSize(Session &session, size_t size);
-  virtual ErrorCode onSetMaxPayloadSize(Session &session, size_t size);
-
   virtual void onSetLogging(Session &session, std::string const &mode,
                             std::string const &filename,
                             StringCollection const &flags);
@@ -98,11 +95,14 @@ protected: // Debugging Session
 
   //
   // If lastTid is kAllThreadId, it's the first request; if it's kAnyThreadId
-  // the next of the previous request, in any other case the thread next to
-  // the one specified.
+  // the next of the previous request, in any other case the threads next to
+  // the one specified. At most count threads are returned at once.
   //
   virtual ErrorCode onQueryThreadList(Session &session, ProcessId pid,
-                                      ThreadId lastTid, ThreadId &tid);
+                                      ThreadId lastTid, size_t count,
+                                      std::vector<ThreadId> &tids);
+  virtual ErrorCode onQueryThreadsInfo(Session &session, ProcessId pid,
+                                       std::string &buffer);
 
   virtual ErrorCode onQueryThreadStopInfo(Session &session,
                                           ProcessThreadId const &ptid,
@@ -160,6 +160,8 @@ protected: // Debugging Session
 
   virtual ErrorCode onReadMemory(Session &session, Address const &address,
                                  size_t length, std::string &data);
+  virtual ErrorCode onReadMemory(Session &session,
+                                 MemoryRange::Collection &ranges);
   virtual ErrorCode onWriteMemory(Session &session, Address const &address,
                                   std::string const &data, size_t &nwritten);
 
@@ -175,7 +177,8 @@ protected: // Debugging Session
                                  size_t length, uint32_t &crc);
 
   virtual ErrorCode onSearch(Session &session, Address const &address,
-                             std::string const &pattern, Address &location);
+                             size_t length, std::string const &pattern,
+                             Address &location);
   virtual ErrorCode onSearchBackward(Session &session, Address const &address,
                                      uint32_t pattern, uint32_t mask,
                                      Address &location);
@@ -20,9 +20,23 @@ struct PacketProcessorDelegate;
 
 class PacketProcessor {
 protected:
+  enum State { kStateIdle, kStatePayload, kStateChecksum1, kStateChecksum2 };
+
+protected:
+  State _state;
+  //
+  // Packets entirely contained in the data being parsed are handed to the
+  // delegate in place; only a packet split across several receives gets
+  // accumulated in _buffer, whose storage is kept from one packet to the
+  // next.
+  //
   std::string _buffer;
-  size_t _nreqs;
-  bool _needhash;
+  bool _buffered;
+  size_t _payloadStart;
+  size_t _payloadEnd;
+  uint8_t _csum;
+  uint8_t _expectedCsum;
+  bool _validCsum;
   PacketProcessorDelegate *_delegate;
 
 public:
@@ -37,18 +51,22 @@ public:
   }
 
 public:
-  void parse(std::string const &data);
-
-private:
-  void process();
+  void parse(char const *data, size_t length);
+  inline void parse(std::string const &data) {
+    parse(data.c_str(), data.length());
+  }
 
 private:
-  bool validate();
+  void process(char const *data);
+  size_t skipInvalidData(char const *data, size_t length, size_t first);
 };
 
 struct PacketProcessorDelegate {
-  virtual void onPacketData(std::string const &data, bool valid) = 0;
-  virtual void onInvalidData(std::string const &data) = 0;
+  //
+  // The data is only valid for the duration of the call.
+  //
+  virtual void onPacketData(char const *data, size_t length, bool valid) = 0;
+  virtual void onInvalidData(char const *data, size_t length) = 0;
 };
 }
 }
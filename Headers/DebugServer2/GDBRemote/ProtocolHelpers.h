@@ -20,11 +20,15 @@ uint8_t Checksum(std::string const &data);
 
 std::string Escape(std::string const &data);
 
+size_t EscapedPrefixLength(std::string const &data, size_t size);
+
 std::string Unescape(std::string const &data);
 
 std::string Compress(std::string const &data);
 
 std::string Uncompress(std::string const &data);
+
+std::string EscapeJSON(std::string const &data);
 }
 }
 
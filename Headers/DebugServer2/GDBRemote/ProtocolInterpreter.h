@@ -22,25 +22,46 @@ struct ProtocolHandler;
 class ProtocolInterpreter : public PacketProcessorDelegate {
 public:
   struct Handler {
-    typedef std::vector<Handler> Collection;
-
     typedef void (ProtocolHandler::*Callback)(Handler const &handler,
                                               std::string const &data);
 
+    //
+    // Looks up the handler for a command; tables are static so that
+    // building a session doesn't register anything.
+    //
+    typedef Handler const *(*Lookup)(char const *command, size_t length);
+
     enum Mode { kModeEquals, kModeStartsWith };
 
     Mode mode;
-    std::string command;
-    ProtocolHandler *handler;
+    char const *command;
+    size_t length;
     Callback callback;
 
-    int compare(std::string const &command) const;
+    bool matches(char const *command, size_t length) const;
+
+    //
+    // FNV-1a hash of a command name. The constexpr form is meant to be used
+    // in case labels so that two commands hashing to the same value fail to
+    // compile, the other one is used on received packets.
+    //
+    static constexpr uint32_t ConstHash(char const *command, size_t length,
+                                        uint32_t hash = 2166136261u) {
+      return length == 0
+                 ? hash
+                 : ConstHash(command + 1, length - 1,
+                             (hash ^ static_cast<uint8_t>(*command)) *
+                                 16777619u);
+    }
+    static uint32_t Hash(char const *command, size_t length);
   };
 
 private:
   SessionBase *_session;
-  Handler::Collection _handlers;
+  ProtocolHandler *_handler;
+  Handler::Lookup _lookup;
   std::vector<std::string> _lastCommands;
+  std::string _arguments;
 
 public:
   ProtocolInterpreter();
@@ -52,26 +73,22 @@ public:
   }
 
 public:
-  void onCommand(std::string const &command, std::string const &arguments);
-
-public:
-  bool registerHandler(Handler const &handler);
-
-  template <typename CallbackType>
-  inline bool
-  registerHandler(Handler::Mode const &mode, std::string const &command,
-                  ProtocolHandler *handler, CallbackType const &callback) {
-    Handler hndlr = {mode, command, handler, (Handler::Callback)callback};
-    return registerHandler(hndlr);
+  inline void setHandlers(ProtocolHandler *handler, Handler::Lookup lookup) {
+    _handler = handler;
+    _lookup = lookup;
   }
 
 private:
-  Handler const *findHandler(std::string const &command,
-                             size_t &commandLength) const;
+  void onCommand(char const *data, size_t length, size_t commandEnd,
+                 size_t argsStart);
 
 public:
-  virtual void onPacketData(std::string const &data, bool valid);
-  virtual void onInvalidData(std::string const &data);
+  virtual void onPacketData(char const *data, size_t length, bool valid);
+  virtual void onInvalidData(char const *data, size_t length);
+
+  inline void onPacketData(std::string const &data, bool valid) {
+    onPacketData(data.c_str(), data.length(), valid);
+  }
 
 public:
   inline std::vector<std::string> const &lastCommands() const {
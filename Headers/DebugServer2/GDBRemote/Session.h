@@ -24,12 +24,21 @@ class Session : public SessionBase {
 protected:
   std::map<char, ProcessThreadId> _ptids;
   CompatibilityMode _compatMode;
+  bool _listThreadsInStopReply;
+  std::string _threadsInfoBuffer;
 
 public:
   Session(CompatibilityMode mode);
 
 public:
   virtual CompatibilityMode mode() const { return _compatMode; }
+  inline bool listThreadsInStopReply() const {
+    return _listThreadsInStopReply;
+  }
+
+private:
+  static ProtocolInterpreter::Handler const *FindHandler(char const *command,
+                                                         size_t length);
 
 private:
   void Handle_ControlC(ProtocolInterpreter::Handler const &,
@@ -55,6 +64,12 @@ private:
   void Handle_H(ProtocolInterpreter::Handler const &, std::string const &);
   void Handle_I(ProtocolInterpreter::Handler const &, std::string const &);
   void Handle_i(ProtocolInterpreter::Handler const &, std::string const &);
+  void Handle_jMemoryRegions(ProtocolInterpreter::Handler const &,
+                             std::string const &);
+  void Handle_jMultiMemRead(ProtocolInterpreter::Handler const &,
+                            std::string const &);
+  void Handle_jThreadsInfo(ProtocolInterpreter::Handler const &,
+                           std::string const &);
   void Handle_k(ProtocolInterpreter::Handler const &, std::string const &);
   void Handle__M(ProtocolInterpreter::Handler const &, std::string const &);
   void Handle__m(ProtocolInterpreter::Handler const &, std::string const &);
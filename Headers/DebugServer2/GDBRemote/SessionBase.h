@@ -24,12 +24,17 @@ class SessionDelegate;
 class SessionBase : public ProtocolHandler {
 private:
   Host::Channel *_channel;
+  std::string _receiveBuffer;
   PacketProcessor _processor;
   ProtocolInterpreter _interpreter;
 
 protected:
   SessionDelegate *_delegate;
   bool _ackmode;
+  bool _runLengthEncoding;
+  bool _runLengthEncodingAllowed;
+  uint64_t _runLengthSavedBytes;
+  size_t _packetSize;
 
 public:
   SessionBase();
@@ -66,6 +71,45 @@ public:
 protected:
   inline void setAckMode(bool enabled) { _ackmode = enabled; }
 
+public:
+  //
+  // Whether outgoing packets are run-length encoded, and how many bytes this
+  // saved so far.
+  //
+  inline bool getRunLengthEncoding() const { return _runLengthEncoding; }
+  inline uint64_t getRunLengthSavedBytes() const {
+    return _runLengthSavedBytes;
+  }
+
+protected:
+  inline void setRunLengthEncoding(bool enabled) {
+    _runLengthEncoding = enabled && _runLengthEncodingAllowed;
+  }
+
+public:
+  //
+  // Whether run-length encoding may be turned on once the client negotiates
+  // features; it is allowed unless disabled by the server options.
+  //
+  inline bool getRunLengthEncodingAllowed() const {
+    return _runLengthEncodingAllowed;
+  }
+  inline void setRunLengthEncodingAllowed(bool allowed) {
+    _runLengthEncodingAllowed = allowed;
+    _runLengthEncoding = _runLengthEncoding && allowed;
+  }
+
+public:
+  //
+  // Maximum size of the packet payloads, replies carrying bulk data are
+  // sized to it. Unless set by the client, it depends on the compatibility
+  // mode.
+  //
+  size_t packetSize() const;
+
+protected:
+  inline void setPacketSize(size_t size) { _packetSize = size; }
+
 public:
   inline ProtocolInterpreter &interpreter() const {
     return const_cast<SessionBase *>(this)->_interpreter;
@@ -33,9 +33,6 @@ protected: // Common
   virtual ErrorCode onSetBaudRate(Session &session, uint32_t speed) = 0;
   virtual ErrorCode onToggleDebugFlag(Session &session) = 0;
 
-  virtual ErrorCode onSetMaxPacketSize(Session &session, size_t size) = 0;
-  virtual ErrorCode onSetMaxPayloadSize(Session &session, size_t size) = 0;
-
   virtual void onSetLogging(Session &session, std::string const &mode,
                             std::string const &filename,
                             StringCollection const &flags) = 0;
@@ -105,11 +102,19 @@ protected: // Debugging Session
 
   //
   // If lastTid is kAllThreadId, it's the first request; if it's kAnyThreadId
-  // the next of the previous request, in any other case the thread next to
-  // the one specified.
+  // the next of the previous request, in any other case the threads next to
+  // the one specified. At most count threads are returned at once.
   //
   virtual ErrorCode onQueryThreadList(Session &session, ProcessId pid,
-                                      ThreadId lastTid, ThreadId &tid) = 0;
+                                      ThreadId lastTid, size_t count,
+                                      std::vector<ThreadId> &tids) = 0;
+
+  //
+  // Replaces the contents of buffer with the JSON stop information of all
+  // the threads of the process.
+  //
+  virtual ErrorCode onQueryThreadsInfo(Session &session, ProcessId pid,
+                                       std::string &buffer) = 0;
 
   virtual ErrorCode onQueryCurrentThread(Session &session,
                                          ProcessThreadId &ptid) = 0;
@@ -165,6 +170,8 @@ protected: // Debugging Session
 
   virtual ErrorCode onReadMemory(Session &session, Address const &address,
                                  size_t length, std::string &data) = 0;
+  virtual ErrorCode onReadMemory(Session &session,
+                                 MemoryRange::Collection &ranges) = 0;
   virtual ErrorCode onWriteMemory(Session &session, Address const &address,
                                   std::string const &data,
                                   size_t &nwritten) = 0;
@@ -182,7 +189,8 @@ protected: // Debugging Session
                                  size_t length, uint32_t &crc) = 0;
 
   virtual ErrorCode onSearch(Session &session, Address const &address,
-                             std::string const &pattern, Address &location) = 0;
+                             size_t length, std::string const &pattern,
+                             Address &location) = 0;
   virtual ErrorCode onSearchBackward(Session &session, Address const &address,
                                      uint32_t pattern, uint32_t mask,
                                      Address &location) = 0;
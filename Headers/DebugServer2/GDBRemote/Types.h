@@ -60,12 +60,14 @@ struct StopCode {
   int32_t core;
   Architecture::GPRegisterStopMap registers;
   std::set<ThreadId> threads;
+  std::string threadsInfo;
 
 public:
   StopCode() : event(kSignal), reason(kNone), core(-1) { signal = 0; }
 
 public:
   std::string encode(CompatibilityMode mode) const;
+  void encodeJSON(std::string &buffer) const;
 
 private:
   std::string encodeInfo(CompatibilityMode mode) const;
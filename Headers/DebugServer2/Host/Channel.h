@@ -35,7 +35,11 @@ public:
 
 public:
   virtual bool send(std::string const &buffer);
-  virtual bool receive(std::string &buffer);
+  //
+  // Receives all the available data, reading at most chunkSize bytes at a
+  // time from the underlying channel.
+  //
+  virtual bool receive(std::string &buffer, size_t chunkSize = 0x400);
 };
 }
 }
@@ -19,7 +19,9 @@
 #include <linux/personality.h>
 #undef personality
 #endif
+#include <cerrno>
 #include <sys/syscall.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #if defined(ARCH_X86) && defined(__ANDROID__)
@@ -58,6 +60,45 @@ static inline pid_t wait4(pid_t pid, int *stat_loc, int options,
 }
 #endif
 
+#if !defined(HAVE_GETDENTS64)
+static inline ssize_t getdents64(int fd, void *buffer, size_t length) {
+  return ::syscall(__NR_getdents64, fd, buffer, length);
+}
+#endif
+
+#if !defined(HAVE_PROCESS_VM_READV)
+static inline ssize_t process_vm_readv(pid_t pid, struct iovec const *local_iov,
+                                       unsigned long liovcnt,
+                                       struct iovec const *remote_iov,
+                                       unsigned long riovcnt,
+                                       unsigned long flags) {
+#if defined(__NR_process_vm_readv)
+  return ::syscall(__NR_process_vm_readv, pid, local_iov, liovcnt, remote_iov,
+                   riovcnt, flags);
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+}
+#endif
+
+#if !defined(HAVE_PROCESS_VM_WRITEV)
+static inline ssize_t process_vm_writev(pid_t pid,
+                                        struct iovec const *local_iov,
+                                        unsigned long liovcnt,
+                                        struct iovec const *remote_iov,
+                                        unsigned long riovcnt,
+                                        unsigned long flags) {
+#if defined(__NR_process_vm_writev)
+  return ::syscall(__NR_process_vm_writev, pid, local_iov, liovcnt, remote_iov,
+                   riovcnt, flags);
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+}
+#endif
+
 // We use ds2_snprintf and ds2_vsnprintf in ds2 code to make sure we don't use
 // the bogus vsnprintf provided in the MSVC runtime. The following two defines
 // allow us to avoid #ifdef conditionals accross the code.
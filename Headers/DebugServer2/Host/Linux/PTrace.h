@@ -15,6 +15,20 @@
 
 #include "DebugServer2/Host/POSIX/PTrace.h"
 
+//
+// Older C libraries don't know about the seize-based ptrace requests, these
+// are supported by the kernel since Linux 3.4.
+//
+#if !defined(PTRACE_SEIZE)
+#define PTRACE_SEIZE 0x4206
+#endif
+#if !defined(PTRACE_INTERRUPT)
+#define PTRACE_INTERRUPT 0x4207
+#endif
+#if !defined(PTRACE_LISTEN)
+#define PTRACE_LISTEN 0x4208
+#endif
+
 namespace ds2 {
 namespace Host {
 namespace Linux {
@@ -50,21 +64,34 @@ public:
                                 size_t length, size_t *nwritten = nullptr);
 
 public:
-  virtual ErrorCode readCPUState(ProcessThreadId const &ptid,
-                                 ProcessInfo const &info,
-                                 Architecture::CPUState &state);
-  virtual ErrorCode writeCPUState(ProcessThreadId const &ptid,
-                                  ProcessInfo const &info,
-                                  Architecture::CPUState const &state);
+  virtual ErrorCode
+  readCPUState(ProcessThreadId const &ptid, ProcessArchInfo const &info,
+               Architecture::CPUState &state,
+               uint32_t sets = Architecture::kRegisterSetAll);
+  virtual ErrorCode
+  writeCPUState(ProcessThreadId const &ptid, ProcessArchInfo const &info,
+                Architecture::CPUState const &state,
+                uint32_t sets = Architecture::kRegisterSetAll);
 
 public:
   virtual ErrorCode suspend(ProcessThreadId const &ptid);
 
 public:
-  virtual ErrorCode step(ProcessThreadId const &ptid, ProcessInfo const &pinfo,
-                         int signal = 0, Address const &address = Address());
+  //
+  // Keep a thread that entered a group-stop stopped while still getting
+  // notified when it is continued; only valid for seized threads.
+  //
+  ErrorCode listen(ProcessThreadId const &ptid);
+
+public:
+  inline bool seized() const { return _seized; }
+
+public:
+  virtual ErrorCode step(ProcessThreadId const &ptid,
+                         ProcessArchInfo const &pinfo, int signal = 0,
+                         Address const &address = Address());
   virtual ErrorCode resume(ProcessThreadId const &ptid,
-                           ProcessInfo const &pinfo, int signal = 0,
+                           ProcessArchInfo const &pinfo, int signal = 0,
                            Address const &address = Address());
 
 public:
@@ -77,6 +104,21 @@ protected:
   void initCPUState(ProcessId pid);
   void doneCPUState();
 
+protected:
+  static unsigned long TraceOptions();
+
+protected:
+  ErrorCode readMemoryBulk(ProcessId pid, uint64_t address, void *buffer,
+                           size_t length, size_t &nread);
+  ErrorCode writeMemoryBulk(ProcessId pid, uint64_t address,
+                            void const *buffer, size_t length,
+                            size_t &nwritten);
+  ErrorCode readMemoryWords(ProcessId pid, uint64_t address, void *buffer,
+                            size_t length, size_t &nread);
+  ErrorCode writeMemoryWords(ProcessId pid, uint64_t address,
+                             void const *buffer, size_t length,
+                             size_t &nwritten);
+
   template <typename CommandType, typename AddrType, typename DataType>
   long wrapPtrace(CommandType request, pid_t pid, AddrType addr,
                   DataType data) {
@@ -91,6 +133,10 @@ protected:
 
 public:
   PTracePrivateData *_privateData;
+
+protected:
+  bool _bulkMemoryAccess;
+  bool _seized;
 };
 }
 }
@@ -152,6 +152,9 @@ public:
   static bool EnumerateProcesses(bool allUsers, uid_t uid,
                                  std::function<void(pid_t, uid_t)> const &cb);
   static bool EnumerateThreads(pid_t pid, std::function<void(pid_t)> const &cb);
+  static bool
+  EnumerateMemoryRegions(pid_t pid,
+                         std::function<void(MemoryRegionInfo const &)> const &cb);
 };
 }
 }
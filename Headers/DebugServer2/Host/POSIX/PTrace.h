@@ -48,22 +48,24 @@ public:
                                 size_t length, size_t *nwritten = nullptr) = 0;
 
 public:
-  virtual ErrorCode readCPUState(ProcessThreadId const &ptid,
-                                 ProcessInfo const &info,
-                                 Architecture::CPUState &state) = 0;
-  virtual ErrorCode writeCPUState(ProcessThreadId const &ptid,
-                                  ProcessInfo const &info,
-                                  Architecture::CPUState const &state) = 0;
+  virtual ErrorCode
+  readCPUState(ProcessThreadId const &ptid, ProcessArchInfo const &info,
+               Architecture::CPUState &state,
+               uint32_t sets = Architecture::kRegisterSetAll) = 0;
+  virtual ErrorCode
+  writeCPUState(ProcessThreadId const &ptid, ProcessArchInfo const &info,
+                Architecture::CPUState const &state,
+                uint32_t sets = Architecture::kRegisterSetAll) = 0;
 
 public:
   virtual ErrorCode suspend(ProcessThreadId const &ptid) = 0;
 
 public:
-  virtual ErrorCode step(ProcessThreadId const &ptid, ProcessInfo const &pinfo,
-                         int signal = 0,
+  virtual ErrorCode step(ProcessThreadId const &ptid,
+                         ProcessArchInfo const &pinfo, int signal = 0,
                          Address const &address = Address()) = 0;
   virtual ErrorCode resume(ProcessThreadId const &ptid,
-                           ProcessInfo const &pinfo, int signal = 0,
+                           ProcessArchInfo const &pinfo, int signal = 0,
                            Address const &address = Address()) = 0;
 
 public:
@@ -75,7 +77,7 @@ public:
 
 public:
   virtual ErrorCode execute(ProcessThreadId const &ptid,
-                            ProcessInfo const &pinfo, void const *code,
+                            ProcessArchInfo const &pinfo, void const *code,
                             size_t length, uint64_t &result);
 
 protected:
@@ -34,6 +34,7 @@ public:
 
 public:
   static size_t GetPointerSize();
+  static size_t GetPageSize();
 
 public:
   static char const *GetHostName(bool fqdn = false);
@@ -49,7 +49,7 @@ public:
   virtual ssize_t receive(void *buffer, size_t length);
 
 public:
-  virtual bool receive(std::string &buffer);
+  virtual bool receive(std::string &buffer, size_t chunkSize = 0x400);
 };
 }
 }
@@ -35,6 +35,7 @@ public:
 
 public:
   static size_t GetPointerSize();
+  static size_t GetPageSize();
 
 public:
   static char const *GetHostName(bool fqdn = false);
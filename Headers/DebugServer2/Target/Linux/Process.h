@@ -24,6 +24,9 @@ protected:
   BreakpointManager *_breakpointManager;
   WatchpointManager *_watchpointManager;
   bool _terminated;
+  int _memoryFd;
+  MemoryRegionInfo::Collection _memoryRegions;
+  bool _memoryRegionsValid;
 
 protected:
   friend class POSIX::Process;
@@ -51,6 +54,12 @@ public:
 public:
   virtual ErrorCode getMemoryRegionInfo(Address const &address,
                                         MemoryRegionInfo &info);
+  virtual ErrorCode enumerateMemoryRegions(
+      std::function<void(MemoryRegionInfo const &)> const &cb);
+
+protected:
+  ErrorCode updateMemoryRegions();
+  void invalidateMemoryRegions();
 
 public:
   virtual ErrorCode allocateMemory(size_t size, uint32_t protection,
@@ -84,6 +93,21 @@ protected:
 protected:
   ErrorCode attach(int waitStatus);
 
+protected:
+  virtual void afterExec();
+
+public:
+  virtual void prepareForDetach();
+  virtual ErrorCode beforeResume();
+
+protected:
+  void openMemoryFile();
+  void closeMemoryFile();
+  ErrorCode readMemoryFile(Address const &address, void *data, size_t length,
+                           size_t &nread);
+  ErrorCode writeMemoryFile(Address const &address, void const *data,
+                            size_t length, size_t &nwritten);
+
 public:
   virtual ErrorCode readMemory(Address const &address, void *data,
                                size_t length, size_t *count = nullptr);
@@ -20,6 +20,13 @@ namespace Target {
 namespace Linux {
 
 class Thread : public ds2::Target::POSIX::Thread {
+protected:
+  Architecture::CPUState _cpuState;
+  uint32_t _cpuStateLoaded;
+  uint32_t _cpuStateModified;
+  size_t _cpuStateHits;
+  size_t _cpuStateMisses;
+
 protected:
   friend class Process;
   Thread(Process *process, ThreadId tid);
@@ -38,15 +45,22 @@ public:
   virtual ErrorCode resume(int signal = 0, Address const &address = Address());
 
 public:
-  virtual ErrorCode readCPUState(Architecture::CPUState &state);
-  virtual ErrorCode writeCPUState(Architecture::CPUState const &state);
+  virtual ErrorCode
+  readCPUState(Architecture::CPUState &state,
+               uint32_t sets = Architecture::kRegisterSetAll);
+  virtual ErrorCode
+  writeCPUState(Architecture::CPUState const &state,
+                uint32_t sets = Architecture::kRegisterSetAll);
 
 protected:
-  virtual ErrorCode updateTrapInfo(int waitStatus);
-  virtual void updateState();
+  ErrorCode flushCPUState();
+  void invalidateCPUState();
 
-private:
-  void updateState(bool force);
+public:
+  virtual uint32_t core() const;
+
+protected:
+  virtual ErrorCode updateTrapInfo(int waitStatus);
 
 protected:
   virtual ErrorCode prepareSoftwareSingleStep(Address const &address);
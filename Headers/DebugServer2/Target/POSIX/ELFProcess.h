@@ -23,6 +23,19 @@ protected:
   std::string _auxiliaryVector;
   Address _sharedLibraryInfoAddress;
 
+protected:
+  std::vector<SharedLibrary> _sharedLibraries;
+  bool _sharedLibrariesValid;
+  bool _sharedLibrariesAdded;
+  bool _sharedLibraryTrackingUnsupported;
+  Address _sharedLibraryBreakpoint;
+  Address _entryBreakpoint;
+  bool _sharedLibraryBreakpointDisarmed;
+  bool _internalStop;
+
+protected:
+  ELFProcess();
+
 public:
   virtual ErrorCode getAuxiliaryVector(std::string &auxv);
   virtual uint64_t getAuxiliaryVectorValue(uint64_t type);
@@ -39,9 +52,23 @@ public:
 public:
   virtual bool isELFProcess() const;
 
+public:
+  virtual ErrorCode beforeResume();
+  virtual ErrorCode afterResume();
+  virtual bool isInternalStop() const;
+
 protected:
   virtual ErrorCode updateInfo();
   virtual ErrorCode updateAuxiliaryVector();
+
+protected:
+  virtual void afterExec();
+
+protected:
+  ErrorCode updateSharedLibraries(bool appendOnly);
+  void armSharedLibraryBreakpoint();
+  void stepOverInternalBreakpoint();
+  void handleSharedLibraryEvent();
 };
 }
 }
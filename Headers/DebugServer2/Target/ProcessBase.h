@@ -14,7 +14,9 @@
 #include "DebugServer2/Target/ProcessDecl.h"
 #include "DebugServer2/Target/ThreadBase.h"
 
+#include <deque>
 #include <functional>
+#include <map>
 #include <set>
 
 namespace ds2 {
@@ -32,10 +34,19 @@ protected:
   uint32_t _flags;
   ProcessId _pid;
   ProcessInfo _info;
+  ProcessArchInfo _archInfo;
   Address _loadBase;
   Address _entryPoint;
   ThreadBase::IdentityMap _threads;
   Thread *_currentThread;
+  std::set<ThreadId> _breakpointHits;
+
+protected:
+  std::map<uint64_t, std::string> _memoryCache;
+  std::deque<uint64_t> _memoryCacheOrder;
+  size_t _memoryCacheBudget;
+  uint64_t _memoryCacheHits;
+  uint64_t _memoryCacheMisses;
 
 public:
   struct SharedLibrary {
@@ -45,6 +56,7 @@ public:
       uint64_t mapAddress;
       uint64_t baseAddress;
       uint64_t ldAddress;
+      uint64_t nameAddress;
     } svr4;
     std::vector<uint64_t> sections;
   };
@@ -61,6 +73,13 @@ public:
 public:
   inline bool attached() const { return (_flags & kFlagAttachedProcess) != 0; }
 
+public:
+  //
+  // Architecture of the process, suitable for hot paths: unlike getInfo,
+  // this doesn't refresh nor copy the full process information.
+  //
+  inline ProcessArchInfo const &archInfo() const { return _archInfo; }
+
 public:
   inline Address const &loadBase() const { return _loadBase; }
   inline Address const &entryPoint() const { return _entryPoint; }
@@ -69,6 +88,13 @@ public:
   inline Thread *currentThread() const {
     return const_cast<ProcessBase *>(this)->_currentThread;
   }
+
+  //
+  // Makes another stopped thread the one the stop is reported for, e.g. when
+  // it has an event pending from the same stop.
+  //
+  inline void setCurrentThread(Thread *thread) { _currentThread = thread; }
+
   Thread *thread(ThreadId tid) const;
 
 protected:
@@ -117,6 +143,27 @@ public:
   ErrorCode writeMemoryBuffer(Address const &address, std::string const &buffer,
                               size_t length, size_t *nwritten = nullptr);
 
+public:
+  ErrorCode readString(Address const &address, std::string &str,
+                       size_t length);
+
+public:
+  virtual ErrorCode readMemoryRanges(MemoryRange::Collection &ranges);
+
+public:
+  void setMemoryCacheBudget(size_t budget);
+  inline size_t memoryCacheBudget() const { return _memoryCacheBudget; }
+  inline uint64_t memoryCacheHits() const { return _memoryCacheHits; }
+  inline uint64_t memoryCacheMisses() const { return _memoryCacheMisses; }
+
+protected:
+  bool readMemoryCache(Address const &address, size_t length,
+                       std::string &buffer) const;
+  void fillMemoryCache(uint64_t address, std::string const &pages,
+                       size_t length);
+  void invalidateMemoryCache();
+  void invalidateMemoryCache(Address const &address, size_t length);
+
 public:
   virtual ErrorCode allocateMemory(size_t size, uint32_t protection,
                                    uint64_t *address) = 0;
@@ -125,6 +172,8 @@ public:
 public:
   virtual ErrorCode getMemoryRegionInfo(Address const &address,
                                         MemoryRegionInfo &info) = 0;
+  virtual ErrorCode enumerateMemoryRegions(
+      std::function<void(MemoryRegionInfo const &)> const &cb);
 
 public:
   virtual void getThreadIds(std::vector<ThreadId> &tids);
@@ -146,6 +195,16 @@ public:
   virtual void prepareForDetach();
   virtual ErrorCode beforeResume();
   virtual ErrorCode afterResume();
+  virtual bool isInternalStop() const;
+
+protected:
+  //
+  // Whether the thread was moved back onto a breakpoint it executed during
+  // the last stop, as opposed to merely stopping on its address.
+  //
+  inline bool hitBreakpoint(ThreadId tid) const {
+    return _breakpointHits.find(tid) != _breakpointHits.end();
+  }
 
 public:
   virtual Architecture::GDBDescriptor const *
@@ -29,6 +29,7 @@ protected:
   ThreadId _tid;
   TrapInfo _trap;
   State _state;
+  bool _singleStepping;
 
 protected:
   ThreadBase(Process *process, ThreadId tid);
@@ -52,6 +53,12 @@ public:
 public:
   inline State state() const { return _state; }
 
+  //
+  // Whether the thread was last resumed with a single step, either in
+  // hardware or in software; this stays set once the step has stopped.
+  //
+  inline bool singleStepping() const { return _singleStepping; }
+
 public:
   virtual ErrorCode step(int signal = 0,
                          Address const &address = Address()) = 0;
@@ -59,15 +66,19 @@ public:
                            Address const &address = Address()) = 0;
 
 public:
-  virtual ErrorCode readCPUState(Architecture::CPUState &state) = 0;
-  virtual ErrorCode writeCPUState(Architecture::CPUState const &state) = 0;
+  virtual ErrorCode
+  readCPUState(Architecture::CPUState &state,
+               uint32_t sets = Architecture::kRegisterSetAll) = 0;
+  virtual ErrorCode
+  writeCPUState(Architecture::CPUState const &state,
+                uint32_t sets = Architecture::kRegisterSetAll) = 0;
 
 public:
-  inline uint32_t core() const { return _trap.core; }
-
-protected:
-  friend class ProcessBase;
-  virtual void updateState();
+  //
+  // The state is tracked from the events we get from the debugger API, the
+  // core however can change at any time and is only looked up on request.
+  //
+  virtual uint32_t core() const { return _trap.core; }
 
 protected:
   virtual ErrorCode prepareSoftwareSingleStep(Address const &address);
@@ -106,6 +106,7 @@ struct TrapInfo {
     kReasonNone,
     kReasonThreadNew,
     kReasonThreadExit,
+    kReasonGroupStop,
   };
 
   ProcessId pid;
@@ -289,6 +290,30 @@ struct ProcessInfo {
 #endif
 };
 
+//
+// Describes the architecture of a process; unlike ProcessInfo, this is
+// cheap to copy and only changes when the process executes a new image.
+//
+struct ProcessArchInfo {
+  CPUType cpuType;
+  CPUSubType cpuSubType;
+  Endian endian;
+  size_t pointerSize;
+
+  ProcessArchInfo() { clear(); }
+
+  explicit ProcessArchInfo(ProcessInfo const &info)
+      : cpuType(info.cpuType), cpuSubType(info.cpuSubType),
+        endian(info.endian), pointerSize(info.pointerSize) {}
+
+  inline void clear() {
+    cpuType = kCPUTypeAny;
+    cpuSubType = kCPUSubTypeInvalid;
+    endian = kEndianUnknown;
+    pointerSize = 0;
+  }
+};
+
 //
 // Describes a memory region
 //
@@ -298,6 +323,9 @@ struct MemoryRegionInfo {
   Address start;
   uint64_t length;
   uint32_t protection;
+  uint64_t offset;
+  uint64_t inode;
+  std::string name;
 
   MemoryRegionInfo() { clear(); }
 
@@ -305,6 +333,33 @@ struct MemoryRegionInfo {
     start.clear();
     length = 0;
     protection = 0;
+    offset = 0;
+    inode = 0;
+    name.clear();
+  }
+};
+
+//
+// Describes a range of memory to read; once read, holds the bytes that
+// could be read and the outcome of the read.
+//
+struct MemoryRange {
+  typedef std::vector<MemoryRange> Collection;
+
+  Address start;
+  uint64_t length;
+  ErrorCode error;
+  std::string data;
+
+  MemoryRange() { clear(); }
+  MemoryRange(Address const &start_, uint64_t length_)
+      : start(start_), length(length_), error(kSuccess) {}
+
+  inline void clear() {
+    start.clear();
+    length = 0;
+    error = kSuccess;
+    data.clear();
   }
 };
 }
@@ -0,0 +1,32 @@
+//
+// Copyright (c) 2014, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the University of Illinois/NCSA Open
+// Source License found in the LICENSE file in the root directory of this
+// source tree. An additional grant of patent rights can be found in the
+// PATENTS file in the same directory.
+//
+
+#ifndef __DebugServer2_Utils_CRC32_h
+#define __DebugServer2_Utils_CRC32_h
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ds2 {
+
+//
+// Initial value of the CRC computed by GDB for the qCRC packet.
+//
+static uint32_t const kGDBCRC32Initial = 0xffffffff;
+
+//
+// Updates crc with the contents of data, using the CRC-32 polynomial
+// (0x04c11db7) in its non-reflected (most significant bit first) form, as
+// GDB does for the qCRC packet. There is no final XOR.
+//
+uint32_t UpdateGDBCRC32(uint32_t crc, void const *data, size_t length);
+}
+
+#endif // !__DebugServer2_Utils_CRC32_h
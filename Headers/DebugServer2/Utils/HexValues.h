@@ -39,23 +39,40 @@ static inline uint8_t HexToByte(char const *chars) {
   return (HexToNibble(chars[0]) << 4) | HexToNibble(chars[1]);
 }
 
+//
+// Writes the 2 * length lowercase hex digits of data to output.
+//
+void EncodeHex(char *output, void const *data, size_t length);
+
+//
+// Decodes the length hex digits of input, length being even, into the
+// length / 2 bytes of output. Returns false if any character is not a hex
+// digit, in which case the contents of output are unspecified.
+//
+bool DecodeHex(void *output, char const *input, size_t length);
+
+//
+// Returns the sum of the length bytes of data, modulo 256.
+//
+uint8_t SumBytes(void const *data, size_t length);
+
 static inline std::string StringToHex(std::string const &str) {
-  std::string result;
-  for (size_t n = 0; n < str.size(); n++) {
-    result += NibbleToHex(str[n] >> 4);
-    result += NibbleToHex(str[n] & 15);
-  }
+  std::string result(str.size() * 2, '\0');
+  EncodeHex(&result[0], str.data(), str.size());
   return result;
 }
 
-static inline std::string HexToString(std::string const &str) {
-  std::string result;
-  DS2ASSERT(str.size() % 2 == 0);
-  for (size_t n = 0; n < str.size(); n += 2) {
-    result +=
-        static_cast<char>((HexToNibble(str[n]) << 4) | HexToNibble(str[n + 1]));
-  }
-  return result;
+static inline bool HexToString(char const *hex, size_t length,
+                               std::string &result) {
+  if (length % 2 != 0)
+    return false;
+
+  result.resize(length / 2);
+  return DecodeHex(&result[0], hex, length);
+}
+
+static inline bool HexToString(std::string const &str, std::string &result) {
+  return HexToString(str.data(), str.size(), result);
 }
 }
 
@@ -0,0 +1,27 @@
+//
+// Copyright (c) 2014, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the University of Illinois/NCSA Open
+// Source License found in the LICENSE file in the root directory of this
+// source tree. An additional grant of patent rights can be found in the
+// PATENTS file in the same directory.
+//
+
+#ifndef __DebugServer2_Utils_MemorySearch_h
+#define __DebugServer2_Utils_MemorySearch_h
+
+#include <cstddef>
+
+namespace ds2 {
+
+//
+// Returns a pointer to the first occurrence of needle in haystack, or
+// nullptr if there is none. This is a memmem(3) that uses SIMD compares when
+// the host supports them.
+//
+void const *SearchMemory(void const *haystack, size_t haystackLength,
+                         void const *needle, size_t needleLength);
+}
+
+#endif // !__DebugServer2_Utils_MemorySearch_h
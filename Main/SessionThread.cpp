@@ -28,13 +28,12 @@ void SessionThread::run() {
   //
   // Wait for a message and pass down to the packet processor.
   //
+  std::string data;
   while (_channel->connected()) {
-    std::string data;
-
     if (!_channel->remote()->wait())
       break;
 
-    if (!_channel->remote()->receive(data))
+    if (!_channel->remote()->receive(data, _session->packetSize() + 4))
       break;
 
     _pp.parse(data);
@@ -43,8 +42,9 @@ void SessionThread::run() {
   _channel->close();
 }
 
-void SessionThread::onPacketData(std::string const &data, bool valid) {
-  if (data.length() == 1 && data[0] == '\x03') {
+void SessionThread::onPacketData(char const *data, size_t length,
+                                 bool valid) {
+  if (length == 1 && data[0] == '\x03') {
     //
     // Interrupt process, this is the highest priority message
     // we can receive, as such we must deliver it to the delegate
@@ -57,7 +57,7 @@ void SessionThread::onPacketData(std::string const &data, bool valid) {
     // of Linux threading and ptrace(2) system call.
     //
     _channel->queue().clear(false);
-    _session->interpreter().onPacketData(data, valid);
+    _session->interpreter().onPacketData(data, length, valid);
   } else {
     if (_session->getAckMode() && !valid) {
       //
@@ -66,20 +66,20 @@ void SessionThread::onPacketData(std::string const &data, bool valid) {
       // thread is safe when valid is false as there's no interaction
       // with the system in such a case.
       //
-      _session->interpreter().onPacketData(data, valid);
+      _session->interpreter().onPacketData(data, length, valid);
     } else {
       //
       // This is a normal valid message, enqueue it, the main thread will
       // activate to fetch the message and process it.
       //
-      _channel->queue().put(data);
+      _channel->queue().put(std::string(data, length));
     }
   }
 }
 
-void SessionThread::onInvalidData(std::string const &data) {
+void SessionThread::onInvalidData(char const *data, size_t length) {
   //
   // Forward to the session's interpreter.
   //
-  _session->interpreter().onInvalidData(data);
+  _session->interpreter().onInvalidData(data, length);
 }
@@ -33,8 +33,8 @@ public:
   void start();
 
 protected:
-  virtual void onPacketData(std::string const &data, bool valid);
-  virtual void onInvalidData(std::string const &data);
+  virtual void onPacketData(char const *data, size_t length, bool valid);
+  virtual void onInvalidData(char const *data, size_t length);
 
 private:
   void run();
@@ -46,6 +46,7 @@ using ds2::GDBRemote::SlaveSessionImpl;
 static uint16_t gDefaultPort = 12345;
 static bool gKeepAlive = false;
 static bool gLLDBCompat = false;
+static bool gRunLengthEncoding = true;
 
 #if !defined(_WIN32)
 static void PlatformMain(int argc, char **argv, int port) {
@@ -91,6 +92,7 @@ static void RunDebugServer(Socket *server, SessionDelegate *impl) {
   SessionThread thread(qchannel, &session);
 
   session.setDelegate(impl);
+  session.setRunLengthEncodingAllowed(gRunLengthEncoding);
   session.create(qchannel);
 
   DS2LOG(Main, Debug, "DEBUG SERVER STARTED");
@@ -268,6 +270,8 @@ int main(int argc, char **argv) {
                  "disable colored output");
   opts.addOption(ds2::OptParse::boolOption, "keep-alive", 'k',
                  "keep the server alive after the client disconnects");
+  opts.addOption(ds2::OptParse::boolOption, "no-run-length-encoding", 'C',
+                 "never run-length encode the packets sent to the client");
 
   // Target debug options.
   opts.addOption(ds2::OptParse::stringOption, "attach", 'a',
@@ -334,6 +338,7 @@ int main(int argc, char **argv) {
   }
 
   gKeepAlive = opts.getBool("keep-alive");
+  gRunLengthEncoding = !opts.getBool("no-run-length-encoding");
 
   if (!opts.getString("attach").empty()) {
     attachPid = atoi(opts.getString("attach").c_str());
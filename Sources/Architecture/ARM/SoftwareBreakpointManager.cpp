@@ -48,7 +48,8 @@ ErrorCode SoftwareBreakpointManager::add(Address const &address, Type type,
     } else {
       // TODO: add a nicer way to get the thumb bit.
       CPUState state;
-      ErrorCode error = _process->currentThread()->readCPUState(state);
+      ErrorCode error =
+          _process->currentThread()->readCPUState(state, kRegisterSetGP);
       isThumb = ((error == kSuccess) && (state.gp.cpsr & (1 << 5)));
     }
 
@@ -103,7 +104,7 @@ void SoftwareBreakpointManager::enumerate(
 
 bool SoftwareBreakpointManager::hit(Target::Thread *thread) {
   CPUState state;
-  thread->readCPUState(state);
+  thread->readCPUState(state, kRegisterSetGP);
   return super::hit(state.pc());
 }
 
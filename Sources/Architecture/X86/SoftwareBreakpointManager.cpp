@@ -43,12 +43,12 @@ bool SoftwareBreakpointManager::hit(Target::Thread *thread) {
   ds2::Architecture::CPUState state;
 
   //
-  // Ignore hardware signle-stepping.
+  // Ignore hardware signle-stepping, the PC wasn't moved past a breakpoint.
   //
   if (thread->state() == Target::Thread::kStepped)
-    return true;
+    return false;
 
-  thread->readCPUState(state);
+  thread->readCPUState(state, kRegisterSetGP);
   state.setPC(state.pc() - 1);
 
   if (super::hit(state.pc())) {
@@ -56,13 +56,13 @@ bool SoftwareBreakpointManager::hit(Target::Thread *thread) {
     // Move the PC back to the instruction, INT3 will move
     // the instruction pointer to the next byte.
     //
-    if (thread->writeCPUState(state) != kSuccess)
+    if (thread->writeCPUState(state, kRegisterSetGP) != kSuccess)
       abort();
 
 #if !defined(NDEBUG)
     uint64_t ex = state.pc();
 #endif
-    thread->readCPUState(state);
+    thread->readCPUState(state, kRegisterSetGP);
     DS2ASSERT(ex == state.pc());
 
     return true;
@@ -52,6 +52,50 @@ extern RegisterDef const reg_def_ymm13;
 extern RegisterDef const reg_def_ymm14;
 extern RegisterDef const reg_def_ymm15;
 
+// Register Set (avx512-mask)
+extern RegisterDef const reg_def_k0;
+extern RegisterDef const reg_def_k1;
+extern RegisterDef const reg_def_k2;
+extern RegisterDef const reg_def_k3;
+extern RegisterDef const reg_def_k4;
+extern RegisterDef const reg_def_k5;
+extern RegisterDef const reg_def_k6;
+extern RegisterDef const reg_def_k7;
+
+// Register Set (avx512-regs)
+extern RegisterDef const reg_def_zmm0;
+extern RegisterDef const reg_def_zmm1;
+extern RegisterDef const reg_def_zmm2;
+extern RegisterDef const reg_def_zmm3;
+extern RegisterDef const reg_def_zmm4;
+extern RegisterDef const reg_def_zmm5;
+extern RegisterDef const reg_def_zmm6;
+extern RegisterDef const reg_def_zmm7;
+extern RegisterDef const reg_def_zmm8;
+extern RegisterDef const reg_def_zmm9;
+extern RegisterDef const reg_def_zmm10;
+extern RegisterDef const reg_def_zmm11;
+extern RegisterDef const reg_def_zmm12;
+extern RegisterDef const reg_def_zmm13;
+extern RegisterDef const reg_def_zmm14;
+extern RegisterDef const reg_def_zmm15;
+extern RegisterDef const reg_def_zmm16;
+extern RegisterDef const reg_def_zmm17;
+extern RegisterDef const reg_def_zmm18;
+extern RegisterDef const reg_def_zmm19;
+extern RegisterDef const reg_def_zmm20;
+extern RegisterDef const reg_def_zmm21;
+extern RegisterDef const reg_def_zmm22;
+extern RegisterDef const reg_def_zmm23;
+extern RegisterDef const reg_def_zmm24;
+extern RegisterDef const reg_def_zmm25;
+extern RegisterDef const reg_def_zmm26;
+extern RegisterDef const reg_def_zmm27;
+extern RegisterDef const reg_def_zmm28;
+extern RegisterDef const reg_def_zmm29;
+extern RegisterDef const reg_def_zmm30;
+extern RegisterDef const reg_def_zmm31;
+
 // Register Set (eflags)
 extern RegisterDef const reg_def_eflags;
 
@@ -255,8 +299,26 @@ RegisterDef const *const lldb_reg_defs_1[] = {
 LLDBRegisterSet const lldb_reg_set_1 = {"Floating Point Registers", 50,
                                         lldb_reg_defs_1};
 
-LLDBRegisterSet const *const lldb_reg_sets[] = {&lldb_reg_set_0,
-                                                &lldb_reg_set_1, nullptr};
+// LLDB Register Set (AVX-512 Registers)
+
+RegisterDef const *const lldb_reg_defs_2[] = {
+    &reg_def_zmm0,  &reg_def_zmm1,  &reg_def_zmm2,  &reg_def_zmm3,
+    &reg_def_zmm4,  &reg_def_zmm5,  &reg_def_zmm6,  &reg_def_zmm7,
+    &reg_def_zmm8,  &reg_def_zmm9,  &reg_def_zmm10, &reg_def_zmm11,
+    &reg_def_zmm12, &reg_def_zmm13, &reg_def_zmm14, &reg_def_zmm15,
+    &reg_def_zmm16, &reg_def_zmm17, &reg_def_zmm18, &reg_def_zmm19,
+    &reg_def_zmm20, &reg_def_zmm21, &reg_def_zmm22, &reg_def_zmm23,
+    &reg_def_zmm24, &reg_def_zmm25, &reg_def_zmm26, &reg_def_zmm27,
+    &reg_def_zmm28, &reg_def_zmm29, &reg_def_zmm30, &reg_def_zmm31,
+    &reg_def_k0,    &reg_def_k1,    &reg_def_k2,    &reg_def_k3,
+    &reg_def_k4,    &reg_def_k5,    &reg_def_k6,    &reg_def_k7,
+    nullptr};
+
+LLDBRegisterSet const lldb_reg_set_2 = {"AVX-512 Registers", 40,
+                                        lldb_reg_defs_2};
+
+LLDBRegisterSet const *const lldb_reg_sets[] = {
+    &lldb_reg_set_0, &lldb_reg_set_1, &lldb_reg_set_2, nullptr};
 
 //
 // GDB Features
@@ -547,86 +609,134 @@ RegisterDef const *const reg_cnt_defs_r14l[] = {&reg_def_r14, nullptr};
 RegisterDef const *const reg_inv_defs_r15l[] = {
     &reg_def_r15, &reg_def_r15d, &reg_def_r15w, &reg_def_r15l, nullptr};
 RegisterDef const *const reg_cnt_defs_r15l[] = {&reg_def_r15, nullptr};
-RegisterDef const *const reg_inv_defs_ymm0[] = {&reg_def_ymm0, &reg_def_xmm0,
-                                                nullptr};
-RegisterDef const *const reg_inv_defs_ymm1[] = {&reg_def_ymm1, &reg_def_xmm1,
-                                                nullptr};
-RegisterDef const *const reg_inv_defs_ymm2[] = {&reg_def_ymm2, &reg_def_xmm2,
-                                                nullptr};
-RegisterDef const *const reg_inv_defs_ymm3[] = {&reg_def_ymm3, &reg_def_xmm3,
-                                                nullptr};
-RegisterDef const *const reg_inv_defs_ymm4[] = {&reg_def_ymm4, &reg_def_xmm4,
-                                                nullptr};
-RegisterDef const *const reg_inv_defs_ymm5[] = {&reg_def_ymm5, &reg_def_xmm5,
-                                                nullptr};
-RegisterDef const *const reg_inv_defs_ymm6[] = {&reg_def_ymm6, &reg_def_xmm6,
-                                                nullptr};
-RegisterDef const *const reg_inv_defs_ymm7[] = {&reg_def_ymm7, &reg_def_xmm7,
-                                                nullptr};
-RegisterDef const *const reg_inv_defs_ymm8[] = {&reg_def_ymm8, &reg_def_xmm8,
-                                                nullptr};
-RegisterDef const *const reg_inv_defs_ymm9[] = {&reg_def_ymm9, &reg_def_xmm9,
-                                                nullptr};
-RegisterDef const *const reg_inv_defs_ymm10[] = {&reg_def_ymm10, &reg_def_xmm10,
-                                                 nullptr};
-RegisterDef const *const reg_inv_defs_ymm11[] = {&reg_def_ymm11, &reg_def_xmm11,
-                                                 nullptr};
-RegisterDef const *const reg_inv_defs_ymm12[] = {&reg_def_ymm12, &reg_def_xmm12,
-                                                 nullptr};
-RegisterDef const *const reg_inv_defs_ymm13[] = {&reg_def_ymm13, &reg_def_xmm13,
-                                                 nullptr};
-RegisterDef const *const reg_inv_defs_ymm14[] = {&reg_def_ymm14, &reg_def_xmm14,
-                                                 nullptr};
-RegisterDef const *const reg_inv_defs_ymm15[] = {&reg_def_ymm15, &reg_def_xmm15,
-                                                 nullptr};
-RegisterDef const *const reg_inv_defs_xmm0[] = {&reg_def_ymm0, &reg_def_xmm0,
-                                                nullptr};
+RegisterDef const *const reg_inv_defs_ymm0[] = {&reg_def_zmm0, &reg_def_ymm0,
+                                                &reg_def_xmm0, nullptr};
+RegisterDef const *const reg_inv_defs_ymm1[] = {&reg_def_zmm1, &reg_def_ymm1,
+                                                &reg_def_xmm1, nullptr};
+RegisterDef const *const reg_inv_defs_ymm2[] = {&reg_def_zmm2, &reg_def_ymm2,
+                                                &reg_def_xmm2, nullptr};
+RegisterDef const *const reg_inv_defs_ymm3[] = {&reg_def_zmm3, &reg_def_ymm3,
+                                                &reg_def_xmm3, nullptr};
+RegisterDef const *const reg_inv_defs_ymm4[] = {&reg_def_zmm4, &reg_def_ymm4,
+                                                &reg_def_xmm4, nullptr};
+RegisterDef const *const reg_inv_defs_ymm5[] = {&reg_def_zmm5, &reg_def_ymm5,
+                                                &reg_def_xmm5, nullptr};
+RegisterDef const *const reg_inv_defs_ymm6[] = {&reg_def_zmm6, &reg_def_ymm6,
+                                                &reg_def_xmm6, nullptr};
+RegisterDef const *const reg_inv_defs_ymm7[] = {&reg_def_zmm7, &reg_def_ymm7,
+                                                &reg_def_xmm7, nullptr};
+RegisterDef const *const reg_inv_defs_ymm8[] = {&reg_def_zmm8, &reg_def_ymm8,
+                                                &reg_def_xmm8, nullptr};
+RegisterDef const *const reg_inv_defs_ymm9[] = {&reg_def_zmm9, &reg_def_ymm9,
+                                                &reg_def_xmm9, nullptr};
+RegisterDef const *const reg_inv_defs_ymm10[] = {&reg_def_zmm10, &reg_def_ymm10,
+                                                 &reg_def_xmm10, nullptr};
+RegisterDef const *const reg_inv_defs_ymm11[] = {&reg_def_zmm11, &reg_def_ymm11,
+                                                 &reg_def_xmm11, nullptr};
+RegisterDef const *const reg_inv_defs_ymm12[] = {&reg_def_zmm12, &reg_def_ymm12,
+                                                 &reg_def_xmm12, nullptr};
+RegisterDef const *const reg_inv_defs_ymm13[] = {&reg_def_zmm13, &reg_def_ymm13,
+                                                 &reg_def_xmm13, nullptr};
+RegisterDef const *const reg_inv_defs_ymm14[] = {&reg_def_zmm14, &reg_def_ymm14,
+                                                 &reg_def_xmm14, nullptr};
+RegisterDef const *const reg_inv_defs_ymm15[] = {&reg_def_zmm15, &reg_def_ymm15,
+                                                 &reg_def_xmm15, nullptr};
+RegisterDef const *const reg_inv_defs_xmm0[] = {&reg_def_zmm0, &reg_def_ymm0,
+                                                &reg_def_xmm0, nullptr};
 RegisterDef const *const reg_cnt_defs_xmm0[] = {&reg_def_ymm0, nullptr};
-RegisterDef const *const reg_inv_defs_xmm1[] = {&reg_def_ymm1, &reg_def_xmm1,
-                                                nullptr};
+RegisterDef const *const reg_inv_defs_xmm1[] = {&reg_def_zmm1, &reg_def_ymm1,
+                                                &reg_def_xmm1, nullptr};
 RegisterDef const *const reg_cnt_defs_xmm1[] = {&reg_def_ymm1, nullptr};
-RegisterDef const *const reg_inv_defs_xmm2[] = {&reg_def_ymm2, &reg_def_xmm2,
-                                                nullptr};
+RegisterDef const *const reg_inv_defs_xmm2[] = {&reg_def_zmm2, &reg_def_ymm2,
+                                                &reg_def_xmm2, nullptr};
 RegisterDef const *const reg_cnt_defs_xmm2[] = {&reg_def_ymm2, nullptr};
-RegisterDef const *const reg_inv_defs_xmm3[] = {&reg_def_ymm3, &reg_def_xmm3,
-                                                nullptr};
+RegisterDef const *const reg_inv_defs_xmm3[] = {&reg_def_zmm3, &reg_def_ymm3,
+                                                &reg_def_xmm3, nullptr};
 RegisterDef const *const reg_cnt_defs_xmm3[] = {&reg_def_ymm3, nullptr};
-RegisterDef const *const reg_inv_defs_xmm4[] = {&reg_def_ymm4, &reg_def_xmm4,
-                                                nullptr};
+RegisterDef const *const reg_inv_defs_xmm4[] = {&reg_def_zmm4, &reg_def_ymm4,
+                                                &reg_def_xmm4, nullptr};
 RegisterDef const *const reg_cnt_defs_xmm4[] = {&reg_def_ymm4, nullptr};
-RegisterDef const *const reg_inv_defs_xmm5[] = {&reg_def_ymm5, &reg_def_xmm5,
-                                                nullptr};
+RegisterDef const *const reg_inv_defs_xmm5[] = {&reg_def_zmm5, &reg_def_ymm5,
+                                                &reg_def_xmm5, nullptr};
 RegisterDef const *const reg_cnt_defs_xmm5[] = {&reg_def_ymm5, nullptr};
-RegisterDef const *const reg_inv_defs_xmm6[] = {&reg_def_ymm6, &reg_def_xmm6,
-                                                nullptr};
+RegisterDef const *const reg_inv_defs_xmm6[] = {&reg_def_zmm6, &reg_def_ymm6,
+                                                &reg_def_xmm6, nullptr};
 RegisterDef const *const reg_cnt_defs_xmm6[] = {&reg_def_ymm6, nullptr};
-RegisterDef const *const reg_inv_defs_xmm7[] = {&reg_def_ymm7, &reg_def_xmm7,
-                                                nullptr};
+RegisterDef const *const reg_inv_defs_xmm7[] = {&reg_def_zmm7, &reg_def_ymm7,
+                                                &reg_def_xmm7, nullptr};
 RegisterDef const *const reg_cnt_defs_xmm7[] = {&reg_def_ymm7, nullptr};
-RegisterDef const *const reg_inv_defs_xmm8[] = {&reg_def_ymm8, &reg_def_xmm8,
-                                                nullptr};
+RegisterDef const *const reg_inv_defs_xmm8[] = {&reg_def_zmm8, &reg_def_ymm8,
+                                                &reg_def_xmm8, nullptr};
 RegisterDef const *const reg_cnt_defs_xmm8[] = {&reg_def_ymm8, nullptr};
-RegisterDef const *const reg_inv_defs_xmm9[] = {&reg_def_ymm9, &reg_def_xmm9,
-                                                nullptr};
+RegisterDef const *const reg_inv_defs_xmm9[] = {&reg_def_zmm9, &reg_def_ymm9,
+                                                &reg_def_xmm9, nullptr};
 RegisterDef const *const reg_cnt_defs_xmm9[] = {&reg_def_ymm9, nullptr};
-RegisterDef const *const reg_inv_defs_xmm10[] = {&reg_def_ymm10, &reg_def_xmm10,
-                                                 nullptr};
+RegisterDef const *const reg_inv_defs_xmm10[] = {&reg_def_zmm10, &reg_def_ymm10,
+                                                 &reg_def_xmm10, nullptr};
 RegisterDef const *const reg_cnt_defs_xmm10[] = {&reg_def_ymm10, nullptr};
-RegisterDef const *const reg_inv_defs_xmm11[] = {&reg_def_ymm11, &reg_def_xmm11,
-                                                 nullptr};
+RegisterDef const *const reg_inv_defs_xmm11[] = {&reg_def_zmm11, &reg_def_ymm11,
+                                                 &reg_def_xmm11, nullptr};
 RegisterDef const *const reg_cnt_defs_xmm11[] = {&reg_def_ymm11, nullptr};
-RegisterDef const *const reg_inv_defs_xmm12[] = {&reg_def_ymm12, &reg_def_xmm12,
-                                                 nullptr};
+RegisterDef const *const reg_inv_defs_xmm12[] = {&reg_def_zmm12, &reg_def_ymm12,
+                                                 &reg_def_xmm12, nullptr};
 RegisterDef const *const reg_cnt_defs_xmm12[] = {&reg_def_ymm12, nullptr};
-RegisterDef const *const reg_inv_defs_xmm13[] = {&reg_def_ymm13, &reg_def_xmm13,
-                                                 nullptr};
+RegisterDef const *const reg_inv_defs_xmm13[] = {&reg_def_zmm13, &reg_def_ymm13,
+                                                 &reg_def_xmm13, nullptr};
 RegisterDef const *const reg_cnt_defs_xmm13[] = {&reg_def_ymm13, nullptr};
-RegisterDef const *const reg_inv_defs_xmm14[] = {&reg_def_ymm14, &reg_def_xmm14,
-                                                 nullptr};
+RegisterDef const *const reg_inv_defs_xmm14[] = {&reg_def_zmm14, &reg_def_ymm14,
+                                                 &reg_def_xmm14, nullptr};
 RegisterDef const *const reg_cnt_defs_xmm14[] = {&reg_def_ymm14, nullptr};
-RegisterDef const *const reg_inv_defs_xmm15[] = {&reg_def_ymm15, &reg_def_xmm15,
-                                                 nullptr};
+RegisterDef const *const reg_inv_defs_xmm15[] = {&reg_def_zmm15, &reg_def_ymm15,
+                                                 &reg_def_xmm15, nullptr};
 RegisterDef const *const reg_cnt_defs_xmm15[] = {&reg_def_ymm15, nullptr};
+RegisterDef const *const reg_inv_defs_zmm0[] = {&reg_def_zmm0, &reg_def_ymm0,
+                                                &reg_def_xmm0, nullptr};
+RegisterDef const *const reg_inv_defs_zmm1[] = {&reg_def_zmm1, &reg_def_ymm1,
+                                                &reg_def_xmm1, nullptr};
+RegisterDef const *const reg_inv_defs_zmm2[] = {&reg_def_zmm2, &reg_def_ymm2,
+                                                &reg_def_xmm2, nullptr};
+RegisterDef const *const reg_inv_defs_zmm3[] = {&reg_def_zmm3, &reg_def_ymm3,
+                                                &reg_def_xmm3, nullptr};
+RegisterDef const *const reg_inv_defs_zmm4[] = {&reg_def_zmm4, &reg_def_ymm4,
+                                                &reg_def_xmm4, nullptr};
+RegisterDef const *const reg_inv_defs_zmm5[] = {&reg_def_zmm5, &reg_def_ymm5,
+                                                &reg_def_xmm5, nullptr};
+RegisterDef const *const reg_inv_defs_zmm6[] = {&reg_def_zmm6, &reg_def_ymm6,
+                                                &reg_def_xmm6, nullptr};
+RegisterDef const *const reg_inv_defs_zmm7[] = {&reg_def_zmm7, &reg_def_ymm7,
+                                                &reg_def_xmm7, nullptr};
+RegisterDef const *const reg_inv_defs_zmm8[] = {&reg_def_zmm8, &reg_def_ymm8,
+                                                &reg_def_xmm8, nullptr};
+RegisterDef const *const reg_inv_defs_zmm9[] = {&reg_def_zmm9, &reg_def_ymm9,
+                                                &reg_def_xmm9, nullptr};
+RegisterDef const *const reg_inv_defs_zmm10[] = {&reg_def_zmm10, &reg_def_ymm10,
+                                                 &reg_def_xmm10, nullptr};
+RegisterDef const *const reg_inv_defs_zmm11[] = {&reg_def_zmm11, &reg_def_ymm11,
+                                                 &reg_def_xmm11, nullptr};
+RegisterDef const *const reg_inv_defs_zmm12[] = {&reg_def_zmm12, &reg_def_ymm12,
+                                                 &reg_def_xmm12, nullptr};
+RegisterDef const *const reg_inv_defs_zmm13[] = {&reg_def_zmm13, &reg_def_ymm13,
+                                                 &reg_def_xmm13, nullptr};
+RegisterDef const *const reg_inv_defs_zmm14[] = {&reg_def_zmm14, &reg_def_ymm14,
+                                                 &reg_def_xmm14, nullptr};
+RegisterDef const *const reg_inv_defs_zmm15[] = {&reg_def_zmm15, &reg_def_ymm15,
+                                                 &reg_def_xmm15, nullptr};
+RegisterDef const *const reg_inv_defs_zmm16[] = {&reg_def_zmm16, nullptr};
+RegisterDef const *const reg_inv_defs_zmm17[] = {&reg_def_zmm17, nullptr};
+RegisterDef const *const reg_inv_defs_zmm18[] = {&reg_def_zmm18, nullptr};
+RegisterDef const *const reg_inv_defs_zmm19[] = {&reg_def_zmm19, nullptr};
+RegisterDef const *const reg_inv_defs_zmm20[] = {&reg_def_zmm20, nullptr};
+RegisterDef const *const reg_inv_defs_zmm21[] = {&reg_def_zmm21, nullptr};
+RegisterDef const *const reg_inv_defs_zmm22[] = {&reg_def_zmm22, nullptr};
+RegisterDef const *const reg_inv_defs_zmm23[] = {&reg_def_zmm23, nullptr};
+RegisterDef const *const reg_inv_defs_zmm24[] = {&reg_def_zmm24, nullptr};
+RegisterDef const *const reg_inv_defs_zmm25[] = {&reg_def_zmm25, nullptr};
+RegisterDef const *const reg_inv_defs_zmm26[] = {&reg_def_zmm26, nullptr};
+RegisterDef const *const reg_inv_defs_zmm27[] = {&reg_def_zmm27, nullptr};
+RegisterDef const *const reg_inv_defs_zmm28[] = {&reg_def_zmm28, nullptr};
+RegisterDef const *const reg_inv_defs_zmm29[] = {&reg_def_zmm29, nullptr};
+RegisterDef const *const reg_inv_defs_zmm30[] = {&reg_def_zmm30, nullptr};
+RegisterDef const *const reg_inv_defs_zmm31[] = {&reg_def_zmm31, nullptr};
 
 //
 // Flag Sets
@@ -3117,6 +3227,766 @@ RegisterDef const reg_def_orig_rax = {
     0,
     nullptr,
     nullptr};
+RegisterDef const reg_def_zmm0 = {
+    "zmm0",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm0,
+    864,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm0,
+    nullptr};
+RegisterDef const reg_def_zmm1 = {
+    "zmm1",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm1,
+    928,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm1,
+    nullptr};
+RegisterDef const reg_def_zmm2 = {
+    "zmm2",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm2,
+    992,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm2,
+    nullptr};
+RegisterDef const reg_def_zmm3 = {
+    "zmm3",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm3,
+    1056,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm3,
+    nullptr};
+RegisterDef const reg_def_zmm4 = {
+    "zmm4",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm4,
+    1120,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm4,
+    nullptr};
+RegisterDef const reg_def_zmm5 = {
+    "zmm5",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm5,
+    1184,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm5,
+    nullptr};
+RegisterDef const reg_def_zmm6 = {
+    "zmm6",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm6,
+    1248,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm6,
+    nullptr};
+RegisterDef const reg_def_zmm7 = {
+    "zmm7",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm7,
+    1312,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm7,
+    nullptr};
+RegisterDef const reg_def_zmm8 = {
+    "zmm8",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm8,
+    1376,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm8,
+    nullptr};
+RegisterDef const reg_def_zmm9 = {
+    "zmm9",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm9,
+    1440,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm9,
+    nullptr};
+RegisterDef const reg_def_zmm10 = {
+    "zmm10",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm10,
+    1504,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm10,
+    nullptr};
+RegisterDef const reg_def_zmm11 = {
+    "zmm11",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm11,
+    1568,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm11,
+    nullptr};
+RegisterDef const reg_def_zmm12 = {
+    "zmm12",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm12,
+    1632,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm12,
+    nullptr};
+RegisterDef const reg_def_zmm13 = {
+    "zmm13",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm13,
+    1696,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm13,
+    nullptr};
+RegisterDef const reg_def_zmm14 = {
+    "zmm14",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm14,
+    1760,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm14,
+    nullptr};
+RegisterDef const reg_def_zmm15 = {
+    "zmm15",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm15,
+    1824,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm15,
+    nullptr};
+RegisterDef const reg_def_zmm16 = {
+    "zmm16",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm16,
+    1888,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm16,
+    nullptr};
+RegisterDef const reg_def_zmm17 = {
+    "zmm17",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm17,
+    1952,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm17,
+    nullptr};
+RegisterDef const reg_def_zmm18 = {
+    "zmm18",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm18,
+    2016,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm18,
+    nullptr};
+RegisterDef const reg_def_zmm19 = {
+    "zmm19",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm19,
+    2080,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm19,
+    nullptr};
+RegisterDef const reg_def_zmm20 = {
+    "zmm20",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm20,
+    2144,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm20,
+    nullptr};
+RegisterDef const reg_def_zmm21 = {
+    "zmm21",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm21,
+    2208,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm21,
+    nullptr};
+RegisterDef const reg_def_zmm22 = {
+    "zmm22",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm22,
+    2272,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm22,
+    nullptr};
+RegisterDef const reg_def_zmm23 = {
+    "zmm23",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm23,
+    2336,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm23,
+    nullptr};
+RegisterDef const reg_def_zmm24 = {
+    "zmm24",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm24,
+    2400,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm24,
+    nullptr};
+RegisterDef const reg_def_zmm25 = {
+    "zmm25",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm25,
+    2464,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm25,
+    nullptr};
+RegisterDef const reg_def_zmm26 = {
+    "zmm26",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm26,
+    2528,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm26,
+    nullptr};
+RegisterDef const reg_def_zmm27 = {
+    "zmm27",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm27,
+    2592,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm27,
+    nullptr};
+RegisterDef const reg_def_zmm28 = {
+    "zmm28",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm28,
+    2656,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm28,
+    nullptr};
+RegisterDef const reg_def_zmm29 = {
+    "zmm29",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm29,
+    2720,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm29,
+    nullptr};
+RegisterDef const reg_def_zmm30 = {
+    "zmm30",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm30,
+    2784,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm30,
+    nullptr};
+RegisterDef const reg_def_zmm31 = {
+    "zmm31",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    512,
+    -1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_zmm31,
+    2848,
+    ds2::Architecture::kLLDBVectorFormatUInt8,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatVector,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    reg_inv_defs_zmm31,
+    nullptr};
+RegisterDef const reg_def_k0 = {
+    "k0",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    64,
+    ds2::Architecture::X86_64::reg_dwarf_k0,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_k0,
+    2912,
+    ds2::Architecture::kLLDBVectorFormatNone,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatHexadecimal,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    nullptr,
+    nullptr};
+RegisterDef const reg_def_k1 = {
+    "k1",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    64,
+    ds2::Architecture::X86_64::reg_dwarf_k1,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_k1,
+    2920,
+    ds2::Architecture::kLLDBVectorFormatNone,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatHexadecimal,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    nullptr,
+    nullptr};
+RegisterDef const reg_def_k2 = {
+    "k2",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    64,
+    ds2::Architecture::X86_64::reg_dwarf_k2,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_k2,
+    2928,
+    ds2::Architecture::kLLDBVectorFormatNone,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatHexadecimal,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    nullptr,
+    nullptr};
+RegisterDef const reg_def_k3 = {
+    "k3",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    64,
+    ds2::Architecture::X86_64::reg_dwarf_k3,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_k3,
+    2936,
+    ds2::Architecture::kLLDBVectorFormatNone,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatHexadecimal,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    nullptr,
+    nullptr};
+RegisterDef const reg_def_k4 = {
+    "k4",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    64,
+    ds2::Architecture::X86_64::reg_dwarf_k4,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_k4,
+    2944,
+    ds2::Architecture::kLLDBVectorFormatNone,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatHexadecimal,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    nullptr,
+    nullptr};
+RegisterDef const reg_def_k5 = {
+    "k5",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    64,
+    ds2::Architecture::X86_64::reg_dwarf_k5,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_k5,
+    2952,
+    ds2::Architecture::kLLDBVectorFormatNone,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatHexadecimal,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    nullptr,
+    nullptr};
+RegisterDef const reg_def_k6 = {
+    "k6",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    64,
+    ds2::Architecture::X86_64::reg_dwarf_k6,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_k6,
+    2960,
+    ds2::Architecture::kLLDBVectorFormatNone,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatHexadecimal,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    nullptr,
+    nullptr};
+RegisterDef const reg_def_k7 = {
+    "k7",
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    64,
+    ds2::Architecture::X86_64::reg_dwarf_k7,
+    -1,
+    -1,
+    ds2::Architecture::X86_64::reg_lldb_k7,
+    2968,
+    ds2::Architecture::kLLDBVectorFormatNone,
+    ds2::Architecture::kEncodingUInteger,
+    ds2::Architecture::kFormatHexadecimal,
+    {ds2::Architecture::kGDBEncodingSizedInteger, nullptr},
+    0,
+    nullptr,
+    nullptr};
 }
 
 //
@@ -3126,7 +3996,7 @@ namespace ds2 {
 namespace Architecture {
 namespace X86_64 {
 
-LLDBDescriptor const LLDB = {2, lldb_reg_sets};
+LLDBDescriptor const LLDB = {3, lldb_reg_sets};
 GDBDescriptor const GDB = {"i386:x86-64", "GNU/Linux", 3, gdb_features};
 }
 }
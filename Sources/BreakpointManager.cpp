@@ -61,9 +61,19 @@ ErrorCode BreakpointManager::remove(Address const &address) {
   if (it == _sites.end())
     return kErrorNotFound;
 
-  // If we have some sort of temporary breakpoint, just remove it.
-  if (!(it->second.type & kTypePermanent))
-    goto do_remove;
+  // Breakpoints used by the debug server itself can't be removed from here.
+  if (it->second.type == kTypeInternal)
+    return kErrorNotFound;
+
+  // If we have some sort of temporary breakpoint, just remove it, unless the
+  // site is also used internally.
+  if (!(it->second.type & kTypePermanent)) {
+    it->second.type = static_cast<Type>(
+        it->second.type & ~(kTypeTemporaryOneShot | kTypeTemporaryUntilHit));
+    if (!it->second.type)
+      goto do_remove;
+    return kSuccess;
+  }
 
   // If we have a premanent breakpoint, refs should be non-null. If refs is
   // still non-null after the decrement, do not remove the breakpoint and
@@ -72,14 +82,12 @@ ErrorCode BreakpointManager::remove(Address const &address) {
   if (--it->second.refs > 0)
     return kSuccess;
 
-  // If we had a breakpoint that was *only* of type kTypePermanent and refs is
-  // now 0, we need to remove it.
-  if (it->second.type == kTypePermanent)
-    goto do_remove;
-
-  // Otherwise, we had multiple breakpoint types; unset kTypePermanent and
-  // return.
+  // Unset kTypePermanent; if we had a breakpoint that was *only* of type
+  // kTypePermanent and refs is now 0, we need to remove it. Otherwise, we had
+  // multiple breakpoint types and the site stays armed.
   it->second.type = static_cast<Type>(it->second.type & ~kTypePermanent);
+  if (!it->second.type)
+    goto do_remove;
   return kSuccess;
 
 do_remove:
@@ -94,6 +102,42 @@ do_remove:
   return kSuccess;
 }
 
+//
+// Internal breakpoints are used by the debug server itself (e.g. to track
+// shared library loads). They can share a site with breakpoints set by the
+// debugger, are not affected by remove() and survive being hit.
+//
+ErrorCode BreakpointManager::addInternal(Address const &address) {
+  return add(address, kTypeInternal, 0);
+}
+
+ErrorCode BreakpointManager::removeInternal(Address const &address) {
+  if (!address.valid())
+    return kErrorInvalidArgument;
+
+  auto it = _sites.find(address);
+  if (it == _sites.end() || !(it->second.type & kTypeInternal))
+    return kErrorNotFound;
+
+  it->second.type = static_cast<Type>(it->second.type & ~kTypeInternal);
+  if (!it->second.type) {
+    DS2ASSERT(it->second.refs == 0);
+    if (_enabled)
+      disableLocation(it->second);
+    _sites.erase(it);
+  }
+
+  return kSuccess;
+}
+
+bool BreakpointManager::isInternal(Address const &address) const {
+  if (!address.valid())
+    return false;
+
+  auto it = _sites.find(address);
+  return (it != _sites.end() && it->second.type == kTypeInternal);
+}
+
 bool BreakpointManager::has(Address const &address) const {
   if (!address.valid())
     return false;
@@ -9,8 +9,12 @@
 //
 
 #include "DebugServer2/GDB/ByteCodeInterpreter.h"
+#include "DebugServer2/Utils/String.h"
 
+#include <algorithm>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 namespace ds2 {
 namespace GDB {
@@ -519,12 +523,12 @@ int ByteCodeInterpreter::execute(std::string const &bc) {
       uint8_t nargs = bc[pc];
       if (++pc >= bc.size())
         return kErrorShortByteCode;
-      offset = bc[pc];
+      offset = static_cast<uint8_t>(bc[pc]);
       if (++pc >= bc.size())
         return kErrorShortByteCode;
-      offset <<= 8, offset |= bc[pc];
+      offset <<= 8, offset |= static_cast<uint8_t>(bc[pc]);
       pc++;
-      if (pc + offset >= bc.size())
+      if (offset == 0 || pc + offset > bc.size())
         return kErrorShortByteCode;
       int err = printf(
           nargs, std::string(reinterpret_cast<char const *>(&bc[pc]), offset));
@@ -545,17 +549,156 @@ int ByteCodeInterpreter::execute(std::string const &bc) {
   return kSuccess;
 }
 
+//
+// The function and channel are on top of the stack, followed by the
+// arguments, the first one being on top. %s arguments are addresses of
+// strings in the inferior; they are read through the delegate, up to the
+// precision if one is given.
+//
 int ByteCodeInterpreter::printf(size_t nargs, std::string const &format) {
-  // TODO complete me!
-  std::printf("nargs=%u format='%s'\n", (unsigned)nargs, format.c_str());
-  while (nargs-- != 0) {
-    if (!pop())
-      return kErrorStackUnderflow;
-  }
-  if (!pop())
-    return kErrorStackUnderflow; // channel
+  static size_t const kMaxStringLength = 4096;
+
   if (!pop())
     return kErrorStackUnderflow; // function
+  if (!pop())
+    return kErrorStackUnderflow; // channel
+
+  std::vector<int64_t> args;
+  while (args.size() < nargs) {
+    int64_t value;
+    if (!pop(value))
+      return kErrorStackUnderflow;
+    args.push_back(value);
+  }
+
+  std::string output;
+  size_t argn = 0;
+  char const *fmt = format.c_str();
+  while (*fmt != '\0') {
+    if (*fmt != '%') {
+      output += *fmt++;
+      continue;
+    } else if (fmt[1] == '%') {
+      output += '%';
+      fmt += 2;
+      continue;
+    }
+
+    //
+    // Copy flags, width and precision; drop the length modifiers, all
+    // integer arguments are passed as 64-bit values. Width and precision
+    // are clamped so that a format can't make us allocate huge strings.
+    //
+    std::string spec(1, *fmt++);
+    size_t precision = kMaxStringLength;
+    while (*fmt != '\0' && std::strchr("-+ #0", *fmt) != nullptr)
+      spec += *fmt++;
+    if (*fmt >= '0' && *fmt <= '9') {
+      char *eptr;
+      size_t width = std::strtoul(fmt, &eptr, 10);
+      spec += ToString(std::min(width, kMaxStringLength));
+      fmt = eptr;
+    }
+    if (*fmt == '.') {
+      spec += *fmt++;
+      char *eptr;
+      precision = std::min<size_t>(std::strtoul(fmt, &eptr, 10),
+                                   kMaxStringLength);
+      spec += ToString(precision);
+      fmt = eptr;
+    }
+    while (*fmt != '\0' && std::strchr("hlLqjzt", *fmt) != nullptr)
+      fmt++;
+
+    char conversion = *fmt;
+    if (conversion == '\0')
+      break;
+    fmt++;
+
+    int64_t value = (argn < args.size()) ? args[argn++] : 0;
+    char buffer[256];
+    std::string str;
+
+    switch (conversion) {
+    case 'd':
+    case 'i':
+      spec += "ll";
+      spec += conversion;
+      std::snprintf(buffer, sizeof(buffer), spec.c_str(),
+                    static_cast<long long>(value));
+      output += buffer;
+      break;
+
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+      spec += "ll";
+      spec += conversion;
+      std::snprintf(buffer, sizeof(buffer), spec.c_str(),
+                    static_cast<unsigned long long>(value));
+      output += buffer;
+      break;
+
+    case 'c':
+      spec += conversion;
+      std::snprintf(buffer, sizeof(buffer), spec.c_str(),
+                    static_cast<int>(value));
+      output += buffer;
+      break;
+
+    case 'p':
+      std::snprintf(buffer, sizeof(buffer), "0x%llx",
+                    static_cast<unsigned long long>(value));
+      output += buffer;
+      break;
+
+    case 'e':
+    case 'E':
+    case 'f':
+    case 'F':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A': {
+      double d;
+      std::memcpy(&d, &value, sizeof(d));
+      spec += conversion;
+      std::snprintf(buffer, sizeof(buffer), spec.c_str(), d);
+      output += buffer;
+    } break;
+
+    case 's':
+      if (value == 0) {
+        str = "(null)";
+      } else if (!_delegate->readString(static_cast<uint64_t>(value),
+                                        precision,
+                                        str)) {
+        return kErrorBadAddress;
+      }
+      spec += conversion;
+      {
+        int size = std::snprintf(nullptr, 0, spec.c_str(), str.c_str());
+        if (size > 0) {
+          std::string formatted(size + 1, '\0');
+          std::snprintf(&formatted[0], formatted.size(), spec.c_str(),
+                        str.c_str());
+          formatted.resize(size);
+          output += formatted;
+        }
+      }
+      break;
+
+    default:
+      // Unknown conversion, print it as-is.
+      output += spec;
+      output += conversion;
+      break;
+    }
+  }
+
+  std::fputs(output.c_str(), stdout);
+  std::fflush(stdout);
 
   return kSuccess;
 }
@@ -0,0 +1,68 @@
+//
+// Copyright (c) 2014, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the University of Illinois/NCSA Open
+// Source License found in the LICENSE file in the root directory of this
+// source tree. An additional grant of patent rights can be found in the
+// PATENTS file in the same directory.
+//
+
+#include "DebugServer2/GDBRemote/ProtocolHelpers.h"
+
+#include <cstdio>
+
+using ds2::GDBRemote::Compress;
+using ds2::GDBRemote::Escape;
+using ds2::GDBRemote::Uncompress;
+
+static int failures = 0;
+
+static void check(char const *name, std::string const &result,
+                  std::string const &expected) {
+  if (result != expected) {
+    printf("%s: got %zu bytes, expected %zu\n", name, result.length(),
+           expected.length());
+    failures++;
+  }
+}
+
+int main() {
+  //
+  // Edge cases of the run-length encoding described in the protocol
+  // documentation.
+  //
+  check("spec example", Uncompress("0* "), "0000");
+  check("longest run", Uncompress("x*~"), std::string(98, 'x'));
+  check("escaped base", Uncompress("}]* "), std::string(4, '}'));
+  check("escaped base run", Uncompress("}]*!"), std::string(5, '}'));
+  check("escaped star", Uncompress("}\n* "), std::string(4, '*'));
+  check("raw count", Uncompress("a*}]"), std::string(97, 'a') + "]");
+  check("leading star", Uncompress("*a"), "*a");
+  check("trailing star", Uncompress("ab*"), "ab*");
+
+  //
+  // Encoded data must survive a round trip and never use '#' or '$' as run
+  // counts, whatever the run length and character.
+  //
+  for (char c : std::string("0a$#}* ~")) {
+    for (size_t length = 1; length <= 400; length++) {
+      std::string data = "x" + std::string(length, c) + "y";
+      std::string encoded = Compress(Escape(data));
+      for (size_t n = 0; n + 1 < encoded.length(); n++) {
+        if (encoded[n] == '*' &&
+            (encoded[n + 1] == '#' || encoded[n + 1] == '$')) {
+          printf("run of %zu '%c': invalid count\n", length, c);
+          failures++;
+        }
+      }
+      if (Uncompress(encoded) != data) {
+        printf("run of %zu '%c': round trip failed\n", length, c);
+        failures++;
+      }
+    }
+  }
+
+  printf("failures=%d\n", failures);
+  return failures != 0;
+}
@@ -12,13 +12,19 @@
 
 #include "DebugServer2/BreakpointManager.h"
 #include "DebugServer2/GDBRemote/DebugSessionImpl.h"
+#include "DebugServer2/GDBRemote/ProtocolHelpers.h"
 #include "DebugServer2/GDBRemote/Session.h"
 #include "DebugServer2/Host/Platform.h"
+#include "DebugServer2/Utils/CRC32.h"
 #include "DebugServer2/Utils/HexValues.h"
 #include "DebugServer2/Utils/Log.h"
+#include "DebugServer2/Utils/MemorySearch.h"
 
-#include <sstream>
+#include <algorithm>
+#include <cstring>
 #include <iomanip>
+#include <limits>
+#include <sstream>
 
 using ds2::Host::Platform;
 using ds2::Target::Thread;
@@ -56,11 +62,7 @@ size_t DebugSessionImpl::getGPRSize() const {
   if (_process == nullptr)
     return 0;
 
-  ProcessInfo info;
-  if (_process->getInfo(info) != kSuccess)
-    return 0;
-
-  return info.pointerSize << 3;
+  return _process->archInfo().pointerSize << 3;
 }
 
 ErrorCode DebugSessionImpl::onInterrupt(Session &) {
@@ -75,8 +77,9 @@ DebugSessionImpl::onQuerySupported(Session &session,
     DS2LOG(DebugSession, Debug, "gdb feature: %s", feature.name.c_str());
   }
 
-  // TODO PacketSize should be respected
-  localFeatures.push_back(std::string("PacketSize=3fff"));
+  std::ostringstream ss;
+  ss << "PacketSize=" << std::hex << session.packetSize();
+  localFeatures.push_back(ss.str());
   localFeatures.push_back(std::string("ConditionalBreakpoints-"));
   if (_process->breakpointManager() != nullptr) {
     localFeatures.push_back(std::string("BreakpointCommands+"));
@@ -89,6 +92,8 @@ DebugSessionImpl::onQuerySupported(Session &session,
   localFeatures.push_back(std::string("QDisableRandomization+"));
   localFeatures.push_back(std::string("QNonStop+"));
   localFeatures.push_back(std::string("multiprocess+"));
+  localFeatures.push_back(std::string("jMultiMemRead+"));
+  localFeatures.push_back(std::string("jMemoryRegions+"));
   if (_process->isELFProcess()) {
     localFeatures.push_back(std::string("qXfer:auxv:read+"));
   }
@@ -164,14 +169,40 @@ ErrorCode DebugSessionImpl::queryStopCode(Session &session,
   if (thread == nullptr)
     return kErrorProcessNotFound;
 
-  bool readRegisters = true;
+  ErrorCode error = queryThreadStopCode(session, thread, true, stop);
+  if (error != kSuccess)
+    return error;
+
+  _process->enumerateThreads(
+      [&](Thread *thread) { stop.threads.insert(thread->tid()); });
+
+  //
+  // Once the client asked for the thread list in stop replies, also send the
+  // stop reason of every thread so that it does not have to query each of
+  // them with qThreadStopInfo.
+  //
+  if (session.listThreadsInStopReply()) {
+    generateThreadsInfo(session, false, stop.threadsInfo);
+  }
+
+  return kSuccess;
+}
+
+//
+// Fills the stop information of a single thread. Expedited information
+// (name, core and general purpose registers) is only gathered when asked
+// for, as this is what makes the stop information of a thread expensive.
+//
+ErrorCode DebugSessionImpl::queryThreadStopCode(Session &session,
+                                                Thread *thread, bool expedite,
+                                                StopCode &stop) const {
+  bool readRegisters = expedite;
   TrapInfo const &trap = thread->trapInfo();
 
   Architecture::CPUState state;
 
-  stop.ptid.pid = trap.pid;
-  stop.ptid.tid = trap.tid;
-  stop.core = trap.core;
+  stop.ptid.pid = _process->pid();
+  stop.ptid.tid = thread->tid();
   stop.reason = StopCode::kSignalStop;
   switch (trap.event) {
   case TrapInfo::kEventNone:
@@ -201,20 +232,40 @@ ErrorCode DebugSessionImpl::queryStopCode(Session &session,
   }
 
   if (readRegisters) {
+    stop.core = thread->core();
     stop.threadName = Platform::GetThreadName(stop.ptid.pid, stop.ptid.tid);
-    ErrorCode error = thread->readCPUState(state);
+    ErrorCode error =
+        thread->readCPUState(state, Architecture::kRegisterSetGP);
     if (error != kSuccess)
       return error;
     state.getStopGPState(stop.registers,
                          session.mode() == kCompatibilityModeLLDB);
   }
 
-  _process->enumerateThreads(
-      [&](Thread *thread) { stop.threads.insert(thread->tid()); });
-
   return kSuccess;
 }
 
+void DebugSessionImpl::generateThreadsInfo(Session &session, bool expedite,
+                                           std::string &buffer) const {
+  bool first = true;
+
+  buffer.clear();
+  buffer += '[';
+  _process->enumerateThreads([&](Thread *thread) {
+    StopCode stop;
+    if (queryThreadStopCode(session, thread, expedite, stop) != kSuccess) {
+      DS2LOG(DebugSession, Warning,
+             "unable to get stop information of thread %d", thread->tid());
+    }
+    if (!first) {
+      buffer += ',';
+    }
+    stop.encodeJSON(buffer);
+    first = false;
+  });
+  buffer += ']';
+}
+
 ErrorCode DebugSessionImpl::onQueryThreadStopInfo(Session &session,
                                                   ProcessThreadId const &ptid,
                                                   bool list, StopCode &stop) {
@@ -225,8 +276,18 @@ ErrorCode DebugSessionImpl::onQueryThreadStopInfo(Session &session,
   return queryStopCode(session, ptid, stop);
 }
 
+ErrorCode DebugSessionImpl::onQueryThreadsInfo(Session &session, ProcessId,
+                                               std::string &buffer) {
+  if (_process == nullptr)
+    return kErrorProcessNotFound;
+
+  generateThreadsInfo(session, true, buffer);
+  return kSuccess;
+}
+
 ErrorCode DebugSessionImpl::onQueryThreadList(Session &, ProcessId pid,
-                                              ThreadId lastTid, ThreadId &tid) {
+                                              ThreadId lastTid, size_t count,
+                                              std::vector<ThreadId> &tids) {
   if (_process == nullptr)
     return kErrorProcessNotFound;
 
@@ -237,7 +298,6 @@ ErrorCode DebugSessionImpl::onQueryThreadList(Session &, ProcessId pid,
     break;
 
   case kAnyThreadId:
-    _threadIndex++;
     break;
 
   default:
@@ -247,7 +307,9 @@ ErrorCode DebugSessionImpl::onQueryThreadList(Session &, ProcessId pid,
   if (_threadIndex >= _tids.size())
     return kErrorNotFound;
 
-  tid = _tids[_threadIndex];
+  size_t end = std::min(_tids.size(), _threadIndex + count);
+  tids.assign(_tids.begin() + _threadIndex, _tids.begin() + end);
+  _threadIndex = end;
   return kSuccess;
 }
 
@@ -421,6 +483,103 @@ DebugSessionImpl::onQuerySharedLibrariesInfoAddress(Session &,
   return _process->getSharedLibraryInfoAddress(address);
 }
 
+static std::string EscapeXML(std::string const &str) {
+  std::string result;
+  result.reserve(str.length());
+  for (char c : str) {
+    switch (c) {
+    case '&':
+      result += "&amp;";
+      break;
+    case '<':
+      result += "&lt;";
+      break;
+    case '>':
+      result += "&gt;";
+      break;
+    case '"':
+      result += "&quot;";
+      break;
+    default:
+      result += c;
+      break;
+    }
+  }
+  return result;
+}
+
+static std::string ProtectionString(uint32_t protection) {
+  std::string result;
+  result += (protection & kProtectionRead) ? 'r' : '-';
+  result += (protection & kProtectionWrite) ? 'w' : '-';
+  result += (protection & kProtectionExecute) ? 'x' : '-';
+  return result;
+}
+
+//
+// The memory map is generated from the process region index the first time
+// it is requested after a stop, and served from that snapshot for the
+// remaining chunks of the transfer.
+//
+ErrorCode DebugSessionImpl::generateMemoryMap(bool json, std::string &buffer) {
+  std::string &cached = json ? _memoryRegionsJSON : _memoryMapXML;
+  if (!cached.empty()) {
+    buffer = cached;
+    return kSuccess;
+  }
+
+  if (_process == nullptr)
+    return kErrorProcessNotFound;
+
+  std::ostringstream ss;
+  size_t count = 0;
+
+  ss << (json ? "[" : "<memory-map>\n");
+  ErrorCode error = _process->enumerateMemoryRegions(
+      [&](ds2::MemoryRegionInfo const &region) {
+        if (json) {
+          ss << (count == 0 ? "" : ",") << "{\"start\":" << std::dec
+             << region.start.value() << ",\"size\":" << region.length
+             << ",\"permissions\":\"" << ProtectionString(region.protection)
+             << "\"";
+          if (!region.name.empty()) {
+            ss << ",\"name\":\"" << EscapeJSON(region.name) << "\"";
+          }
+          ss << "}";
+        } else {
+          //
+          // GDB only knows the type, start and length attributes and
+          // ignores the others.
+          //
+          ss << "<memory type=\""
+             << ((region.protection & kProtectionWrite) ? "ram" : "rom")
+             << "\" start=\"0x" << std::hex << region.start.value()
+             << "\" length=\"0x" << region.length << "\" permissions=\""
+             << ProtectionString(region.protection) << "\"";
+          if (!region.name.empty()) {
+            ss << " name=\"" << EscapeXML(region.name) << "\"";
+          }
+          ss << "/>\n";
+        }
+        count++;
+      });
+  if (error != kSuccess)
+    return error;
+  ss << (json ? "]" : "</memory-map>\n");
+
+  DS2LOG(DebugSession, Debug, "generated %s memory map with %zu regions",
+         json ? "JSON" : "XML", count);
+
+  cached = ss.str();
+  buffer = cached;
+  return kSuccess;
+}
+
+void DebugSessionImpl::invalidateMemoryMap() {
+  _memoryMapXML.clear();
+  _memoryRegionsJSON.clear();
+}
+
 ErrorCode DebugSessionImpl::onXferRead(Session &, std::string const &object,
                                        std::string const &annex,
                                        uint64_t offset, uint64_t length,
@@ -455,6 +614,18 @@ ErrorCode DebugSessionImpl::onXferRead(Session &, std::string const &object,
       last = false;
     }
 
+    return kSuccess;
+  } else if (object == "memory-map" || object == "memory-regions") {
+    ErrorCode error = generateMemoryMap(object == "memory-regions", buffer);
+    if (error != kSuccess)
+      return error;
+
+    buffer = (offset < buffer.length()) ? buffer.substr(offset) : "";
+    if (buffer.length() > length) {
+      buffer.resize(length);
+      last = false;
+    }
+
     return kSuccess;
   } else if (object == "threads") {
     std::ostringstream ss;
@@ -478,18 +649,26 @@ ErrorCode DebugSessionImpl::onXferRead(Session &, std::string const &object,
     }
     return kSuccess;
   } else if (object == "libraries-svr4") {
-    std::ostringstream ss;
-    std::ostringstream sslibs;
-    Address mainMapAddress;
+    if (!_process->isELFProcess())
+      return kErrorUnsupported;
+
+    //
+    // The library list only changes while the inferior runs; serve the
+    // remaining chunks of a transfer from the document built for the
+    // first one.
+    //
+    if (_sharedLibrariesXML.empty()) {
+      std::ostringstream ss;
+      std::ostringstream sslibs;
+      Address mainMapAddress;
 
-    if (_process->isELFProcess()) {
       _process->enumerateSharedLibraries(
           [&](Target::Process::SharedLibrary const &library) {
             if (library.main) {
               mainMapAddress = library.svr4.mapAddress;
             } else {
               sslibs << "<library "
-                     << "name=\"" << library.path << "\" "
+                     << "name=\"" << EscapeXML(library.path) << "\" "
                      << "lm=\""
                      << "0x" << std::hex << library.svr4.mapAddress << "\" "
                      << "l_addr=\""
@@ -508,13 +687,17 @@ ErrorCode DebugSessionImpl::onXferRead(Session &, std::string const &object,
       ss << ">" << std::endl;
       ss << sslibs.str();
       ss << "</library-list-svr4>";
-      buffer = ss.str().substr(offset);
-      if (buffer.length() > length) {
-        buffer.resize(length);
-        last = false;
-      }
-      return kSuccess;
+      _sharedLibrariesXML = ss.str();
+    }
+
+    buffer = (offset < _sharedLibrariesXML.length())
+                 ? _sharedLibrariesXML.substr(offset)
+                 : "";
+    if (buffer.length() > length) {
+      buffer.resize(length);
+      last = false;
     }
+    return kSuccess;
   }
 
   return kErrorUnsupported;
@@ -528,7 +711,7 @@ ErrorCode DebugSessionImpl::onReadGeneralRegisters(
     return kErrorProcessNotFound;
 
   Architecture::CPUState state;
-  ErrorCode error = thread->readCPUState(state);
+  ErrorCode error = thread->readCPUState(state, Architecture::kRegisterSetGP);
   if (error != kSuccess)
     return error;
 
@@ -544,13 +727,13 @@ ErrorCode DebugSessionImpl::onWriteGeneralRegisters(
     return kErrorProcessNotFound;
 
   Architecture::CPUState state;
-  ErrorCode error = thread->readCPUState(state);
+  ErrorCode error = thread->readCPUState(state, Architecture::kRegisterSetGP);
   if (error != kSuccess)
     return error;
 
   state.setGPState(regs);
 
-  return thread->writeCPUState(state);
+  return thread->writeCPUState(state, Architecture::kRegisterSetGP);
 }
 
 ErrorCode DebugSessionImpl::onSaveRegisters(Session &session,
@@ -600,8 +783,12 @@ ErrorCode DebugSessionImpl::onReadRegisterValue(Session &session,
   if (thread == nullptr)
     return kErrorProcessNotFound;
 
+  //
+  // The general purpose registers tell us the layout of the CPU state; fetch
+  // the other register sets only when the register lives in one of them.
+  //
   Architecture::CPUState state;
-  ErrorCode error = thread->readCPUState(state);
+  ErrorCode error = thread->readCPUState(state, Architecture::kRegisterSetGP);
   if (error != kSuccess)
     return error;
 
@@ -618,6 +805,13 @@ ErrorCode DebugSessionImpl::onReadRegisterValue(Session &session,
   if (!success)
     return kErrorInvalidArgument;
 
+  uint32_t set = state.getRegisterSet(ptr);
+  if (set != Architecture::kRegisterSetGP) {
+    error = thread->readCPUState(state, set);
+    if (error != kSuccess)
+      return error;
+  }
+
   value.insert(value.end(), reinterpret_cast<char *>(ptr),
                reinterpret_cast<char *>(ptr) + length);
 
@@ -633,7 +827,7 @@ ErrorCode DebugSessionImpl::onWriteRegisterValue(Session &session,
     return kErrorProcessNotFound;
 
   Architecture::CPUState state;
-  ErrorCode error = thread->readCPUState(state);
+  ErrorCode error = thread->readCPUState(state, Architecture::kRegisterSetGP);
   if (error != kSuccess)
     return error;
 
@@ -650,12 +844,19 @@ ErrorCode DebugSessionImpl::onWriteRegisterValue(Session &session,
   if (!success)
     return kErrorInvalidArgument;
 
+  uint32_t set = state.getRegisterSet(ptr);
+  if (set != Architecture::kRegisterSetGP) {
+    error = thread->readCPUState(state, set);
+    if (error != kSuccess)
+      return error;
+  }
+
   if (value.length() != length)
     return kErrorInvalidArgument;
 
   std::memcpy(ptr, value.c_str(), length);
 
-  return thread->writeCPUState(state);
+  return thread->writeCPUState(state, set);
 }
 
 ErrorCode DebugSessionImpl::onReadMemory(Session &, Address const &address,
@@ -666,6 +867,14 @@ ErrorCode DebugSessionImpl::onReadMemory(Session &, Address const &address,
     return _process->readMemoryBuffer(address, length, data);
 }
 
+ErrorCode DebugSessionImpl::onReadMemory(Session &,
+                                         MemoryRange::Collection &ranges) {
+  if (_process == nullptr)
+    return kErrorProcessNotFound;
+  else
+    return _process->readMemoryRanges(ranges);
+}
+
 ErrorCode DebugSessionImpl::onWriteMemory(Session &, Address const &address,
                                           std::string const &data,
                                           size_t &nwritten) {
@@ -679,6 +888,7 @@ ErrorCode DebugSessionImpl::onAllocateMemory(Session &, size_t size,
                                              uint32_t permissions,
                                              Address &address) {
   uint64_t addr;
+  invalidateMemoryMap();
   ErrorCode error = _process->allocateMemory(size, permissions, &addr);
   if (error == kSuccess) {
     _allocations[addr] = size;
@@ -693,6 +903,7 @@ ErrorCode DebugSessionImpl::onDeallocateMemory(Session &,
   if (i == _allocations.end())
     return kErrorInvalidArgument;
 
+  invalidateMemoryMap();
   ErrorCode error = _process->deallocateMemory(address, i->second);
   if (error != kSuccess)
     return error;
@@ -701,6 +912,184 @@ ErrorCode DebugSessionImpl::onDeallocateMemory(Session &,
   return kSuccess;
 }
 
+ErrorCode DebugSessionImpl::onQueryMemoryRegionInfo(Session &,
+                                                    Address const &address,
+                                                    MemoryRegionInfo &info) {
+  if (_process == nullptr)
+    return kErrorProcessNotFound;
+
+  return _process->getMemoryRegionInfo(address, info);
+}
+
+//
+// Memory searches and checksums read the inferior in large chunks.
+//
+static size_t const kMemoryChunkSize = 1024 * 1024;
+
+ErrorCode DebugSessionImpl::onComputeCRC(Session &, Address const &address,
+                                         size_t length, uint32_t &crc) {
+  if (_process == nullptr)
+    return kErrorProcessNotFound;
+
+  std::string buffer;
+  buffer.resize(std::min(length, kMemoryChunkSize));
+
+  crc = kGDBCRC32Initial;
+  for (size_t offset = 0; offset < length;) {
+    size_t nwanted = std::min(length - offset, kMemoryChunkSize);
+    ErrorCode error =
+        _process->readMemory(address.value() + offset, &buffer[0], nwanted);
+    if (error != kSuccess)
+      return error;
+
+    crc = UpdateGDBCRC32(crc, buffer.data(), nwanted);
+    offset += nwanted;
+  }
+
+  return kSuccess;
+}
+
+//
+// Searches skip the parts of the address space that are not mapped or not
+// readable.
+//
+
+ErrorCode DebugSessionImpl::onSearch(Session &, Address const &address,
+                                     size_t length, std::string const &pattern,
+                                     Address &location) {
+  if (_process == nullptr)
+    return kErrorProcessNotFound;
+
+  if (pattern.empty() || length < pattern.length())
+    return kErrorInvalidArgument;
+
+  uint64_t pageSize = Platform::GetPageSize();
+  uint64_t current = address.value();
+  uint64_t end = current + length;
+  if (end < current) {
+    end = std::numeric_limits<uint64_t>::max();
+  }
+
+  //
+  // A match can straddle two chunks: the last pattern.length() - 1 bytes of
+  // a chunk are kept and prepended to the next one when it is contiguous.
+  //
+  std::string buffer;
+  uint64_t bufferStart = current;
+
+  while (current < end) {
+    MemoryRegionInfo region;
+    uint64_t regionEnd = end;
+    if (_process->getMemoryRegionInfo(current, region) == kSuccess) {
+      regionEnd = region.start.value() + region.length;
+      if (regionEnd <= current || regionEnd < region.start.value()) {
+        regionEnd = (current & ~(pageSize - 1)) + pageSize;
+      }
+      if (!(region.protection & kProtectionRead)) {
+        current = regionEnd;
+        buffer.clear();
+        continue;
+      }
+      regionEnd = std::min(regionEnd, end);
+    }
+
+    if (bufferStart + buffer.size() != current) {
+      buffer.clear();
+    }
+    bufferStart = current - buffer.size();
+
+    size_t carry = buffer.size();
+    size_t nwanted = std::min<uint64_t>(kMemoryChunkSize, regionEnd - current);
+    buffer.resize(carry + nwanted);
+
+    size_t nread = 0;
+    ErrorCode error =
+        _process->readMemory(current, &buffer[carry], nwanted, &nread);
+    if (error != kSuccess) {
+      nread = 0;
+    }
+    buffer.resize(carry + nread);
+
+    void const *match = SearchMemory(buffer.data(), buffer.size(),
+                                     pattern.data(), pattern.length());
+    if (match != nullptr) {
+      location = bufferStart + (static_cast<char const *>(match) - &buffer[0]);
+      return kSuccess;
+    }
+
+    if (buffer.size() >= pattern.length()) {
+      buffer.erase(0, buffer.size() - (pattern.length() - 1));
+    }
+    bufferStart = current + nread - buffer.size();
+    current += nread;
+
+    if (nread < nwanted) {
+      //
+      // Skip the page we could not read.
+      //
+      current = (current & ~(pageSize - 1)) + pageSize;
+      buffer.clear();
+    }
+  }
+
+  return kErrorNotFound;
+}
+
+ErrorCode DebugSessionImpl::onSearchBackward(Session &, Address const &address,
+                                             uint32_t pattern, uint32_t mask,
+                                             Address &location) {
+  if (_process == nullptr)
+    return kErrorProcessNotFound;
+
+  uint64_t top = address.value();
+  std::string buffer;
+
+  for (;;) {
+    MemoryRegionInfo region;
+    uint64_t bottom = 0;
+    if (_process->getMemoryRegionInfo(top, region) == kSuccess) {
+      bottom = region.start.value();
+      if (!(region.protection & kProtectionRead)) {
+        if (bottom == 0)
+          break;
+        top = bottom - 1;
+        continue;
+      }
+    }
+
+    //
+    // Candidates are in [low, top]; read the three bytes above top too so
+    // that the candidates near top can be compared entirely.
+    //
+    uint64_t low = std::max<uint64_t>(
+        bottom, top >= kMemoryChunkSize ? top - kMemoryChunkSize + 1 : 0);
+    buffer.resize(top - low + sizeof(uint32_t));
+
+    size_t nread = 0;
+    if (_process->readMemory(low, &buffer[0], buffer.size(), &nread) !=
+        kSuccess) {
+      nread = 0;
+    }
+
+    for (uint64_t offset = top - low + 1; offset-- > 0;) {
+      uint32_t value;
+      if (offset + sizeof(value) > nread)
+        continue;
+      std::memcpy(&value, &buffer[offset], sizeof(value));
+      if ((value & mask) == (pattern & mask)) {
+        location = low + offset;
+        return kSuccess;
+      }
+    }
+
+    if (low == 0)
+      break;
+    top = low - 1;
+  }
+
+  return kErrorNotFound;
+}
+
 ErrorCode
 DebugSessionImpl::onSetProgramArguments(Session &,
                                         StringCollection const &args) {
@@ -740,11 +1129,16 @@ DebugSessionImpl::onResume(Session &session,
   ThreadResumeAction globalAction;
   bool hasGlobalAction = false;
   std::set<Thread *> excluded;
+  std::set<ThreadId> held;
+  Thread *pending = nullptr;
 
   DS2ASSERT(_resumeSession == nullptr);
   _resumeSession = &session;
   _resumeSessionLock.unlock();
 
+  invalidateMemoryMap();
+  _sharedLibrariesXML.clear();
+
   error = _process->beforeResume();
   if (error != kSuccess)
     goto ret;
@@ -831,6 +1225,16 @@ DebugSessionImpl::onResume(Session &session,
     }
   }
 
+  //
+  // Threads the actions left stopped must stay stopped when the debug server
+  // resumes the process on its own.
+  //
+  _process->enumerateThreads([&](Thread *thread) {
+    if (thread->state() == Thread::kStopped) {
+      held.insert(thread->tid());
+    }
+  });
+
   //
   // If kErrorAlreadyExist is set, then a signal is already pending.
   //
@@ -847,6 +1251,27 @@ DebugSessionImpl::onResume(Session &session,
   if (error != kSuccess)
     goto ret;
 
+  //
+  // Stops caused by the debug server itself (e.g. shared library events)
+  // are not reported.
+  //
+  while (_process->isInternalStop()) {
+    DS2LOG(DebugSession, Debug, "internal stop, resuming");
+    error = resumeAfterInternalStop(held, pending);
+    if (error != kSuccess || pending != nullptr)
+      break;
+
+    error = _process->wait();
+    if (error != kSuccess)
+      break;
+
+    error = _process->afterResume();
+    if (error != kSuccess)
+      break;
+  }
+  if (error != kSuccess)
+    goto ret;
+
   error = queryStopCode(
       session,
       ProcessThreadId(_process->pid(), _process->currentThread()->tid()), stop);
@@ -857,6 +1282,67 @@ ret:
   return error;
 }
 
+//
+// The actions of the debugger were applied when the process was resumed;
+// replaying them after an internal stop would step threads twice or deliver
+// signals again. Instead, every thread that was running goes on as it was,
+// with no signal, and a thread whose single step was interrupted by the
+// stop is stepped again. A thread that stopped for a reason of its own in
+// the meantime (e.g. its single step completed) is returned in pending and
+// nothing is resumed, its stop gets reported instead.
+//
+ErrorCode DebugSessionImpl::resumeAfterInternalStop(
+    std::set<ThreadId> const &held, Thread *&pending) {
+  Thread *internal = _process->currentThread();
+  std::set<ThreadId> stepping;
+
+  pending = nullptr;
+  _process->enumerateThreads([&](Thread *thread) {
+    if (thread == internal || thread->state() != Thread::kStopped ||
+        held.find(thread->tid()) != held.end())
+      return;
+
+    if (thread->trapInfo().event != TrapInfo::kEventNone) {
+      if (pending == nullptr) {
+        pending = thread;
+      }
+    } else if (thread->singleStepping()) {
+      stepping.insert(thread->tid());
+    }
+  });
+
+  //
+  // This moves the thread past the internal breakpoint.
+  //
+  ErrorCode error = _process->beforeResume();
+  if (error != kSuccess)
+    return error;
+
+  if (pending != nullptr) {
+    error = _process->afterResume();
+    _process->setCurrentThread(pending);
+    return error;
+  }
+
+  _process->enumerateThreads([&](Thread *thread) {
+    if (thread->state() != Thread::kStopped ||
+        held.find(thread->tid()) != held.end())
+      return;
+
+    if (stepping.find(thread->tid()) != stepping.end()) {
+      error = thread->step();
+    } else {
+      error = thread->resume();
+    }
+    if (error != kSuccess) {
+      DS2LOG(DebugSession, Warning, "cannot resume pid %d tid %d, error=%d",
+             _process->pid(), thread->tid(), error);
+    }
+  });
+
+  return kSuccess;
+}
+
 ErrorCode DebugSessionImpl::onDetach(Session &, ProcessId, bool stopped) {
   ErrorCode error;
 
@@ -37,14 +37,6 @@ ErrorCode DummySessionDelegateImpl::onToggleDebugFlag(Session &) {
   return kSuccess;
 }
 
-ErrorCode DummySessionDelegateImpl::onSetMaxPacketSize(Session &, size_t) {
-  return kErrorUnsupported;
-}
-
-ErrorCode DummySessionDelegateImpl::onSetMaxPayloadSize(Session &, size_t) {
-  return kErrorUnsupported;
-}
-
 void DummySessionDelegateImpl::onSetLogging(Session &, std::string const &,
                                             std::string const &,
                                             StringCollection const &) {}
@@ -219,8 +211,13 @@ ErrorCode DummySessionDelegateImpl::onSynchronizeThreadState(Session &,
   return kErrorUnsupported;
 }
 
-ErrorCode DummySessionDelegateImpl::onQueryThreadList(Session &, ProcessId,
-                                                      ThreadId, ThreadId &) {
+ErrorCode DummySessionDelegateImpl::onQueryThreadList(
+    Session &, ProcessId, ThreadId, size_t, std::vector<ThreadId> &) {
+  return kErrorUnsupported;
+}
+
+ErrorCode DummySessionDelegateImpl::onQueryThreadsInfo(Session &, ProcessId,
+                                                       std::string &) {
   return kErrorUnsupported;
 }
 
@@ -313,6 +310,11 @@ ErrorCode DummySessionDelegateImpl::onReadMemory(Session &, Address const &,
   return kErrorUnsupported;
 }
 
+ErrorCode DummySessionDelegateImpl::onReadMemory(Session &,
+                                                 MemoryRange::Collection &) {
+  return kErrorUnsupported;
+}
+
 ErrorCode DummySessionDelegateImpl::onWriteMemory(Session &, Address const &,
                                                   std::string const &,
                                                   size_t &) {
@@ -347,7 +349,8 @@ ErrorCode DummySessionDelegateImpl::onSearchBackward(Session &, Address const &,
 }
 
 ErrorCode DummySessionDelegateImpl::onSearch(Session &, Address const &,
-                                             std::string const &, Address &) {
+                                             size_t, std::string const &,
+                                             Address &) {
   return kErrorUnsupported;
 }
 
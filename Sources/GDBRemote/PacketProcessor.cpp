@@ -9,127 +9,143 @@
 //
 
 #include "DebugServer2/GDBRemote/PacketProcessor.h"
-#include "DebugServer2/GDBRemote/ProtocolHelpers.h"
+#include "DebugServer2/Utils/HexValues.h"
 #include "DebugServer2/Utils/Log.h"
 
-#include <cstdlib>
+#include <cctype>
+#include <cstring>
 
 namespace ds2 {
 namespace GDBRemote {
 
 PacketProcessor::PacketProcessor()
-    : _nreqs(0), _needhash(false), _delegate(nullptr) {}
+    : _state(kStateIdle), _buffered(false), _payloadStart(0), _payloadEnd(0),
+      _csum(0), _expectedCsum(0), _validCsum(false), _delegate(nullptr) {}
 
-bool PacketProcessor::validate() {
-  if (_buffer.empty())
-    return false;
-
-  if (_buffer[0] == '+' || _buffer[0] == '-' || _buffer[0] == '\x03')
-    return true;
-
-  size_t csoff = _buffer.find('#');
-  uint8_t csum =
-      static_cast<uint8_t>(std::strtoul(&_buffer[csoff + 1], nullptr, 16));
+static inline bool IsPacketStart(char c) {
+  return c == '$' || c == '+' || c == '-' || c == '\x03';
+}
 
-  _buffer.erase(0, 1);
-  _buffer.erase(csoff - 1);
+void PacketProcessor::process(char const *data) {
+  char const *payload;
+  size_t length;
 
-  uint8_t our_csum = Checksum(_buffer);
+  if (_buffered) {
+    payload = _buffer.c_str();
+    length = _buffer.length();
+  } else {
+    payload = data + _payloadStart;
+    length = _payloadEnd - _payloadStart;
+  }
 
-  if (csum != our_csum)
+  bool valid = _validCsum && _csum == _expectedCsum;
+  if (!valid) {
     DS2LOG(Protocol, Info,
-           "received packet %s with invalid checksum, should be %.2x, is %.2x",
-           _buffer.c_str(), our_csum, csum);
-
-  return csum == our_csum;
-}
-
-void PacketProcessor::process() {
-  _delegate->onPacketData(_buffer, validate());
-  _buffer.clear();
-  _nreqs = 0;
-}
-
-void PacketProcessor::parse(std::string const &data) {
-  size_t n = _nreqs;
+           "received packet %.*s with invalid checksum, should be %.2x, is "
+           "%.2x",
+           static_cast<int>(length), payload, _csum, _expectedCsum);
+  }
 
-  if (data.empty() || _delegate == nullptr)
-    return;
+  _state = kStateIdle;
+  _delegate->onPacketData(payload, length, valid);
 
   //
-  // Do we need to complete a packet?
+  // Keep the storage around for the next split packet.
   //
-  if (n != 0 && data.length() != 0) {
-    _buffer += data.substr(0, n);
-    if (data.length() < _nreqs) {
-      _nreqs -= data.length();
-      if (_nreqs != 0)
-        return;
-    }
+  _buffer.clear();
+  _buffered = false;
+}
 
-    process();
+size_t PacketProcessor::skipInvalidData(char const *data, size_t length,
+                                        size_t first) {
+  size_t n = first;
+  while (n < length && !IsPacketStart(data[n])) {
+    n++;
   }
 
-  //
-  // First will be std::string::npos if a packet
-  // has been processed.
-  //
-  size_t first = n;
-  while (n < data.size()) {
-    size_t end = std::string::npos;
-    if (_needhash) {
-      _needhash = false;
-      goto hash;
-    }
+  _delegate->onInvalidData(data + first, n - first);
+  return n;
+}
+
+//
+// Packets are parsed incrementally: the payload checksum is computed as the
+// bytes arrive, so that data which is received in several chunks is only
+// looked at once.
+//
+void PacketProcessor::parse(char const *data, size_t length) {
+  if (length == 0 || _delegate == nullptr)
+    return;
 
-    switch (data[n]) {
-    case '+':    // ACK
-    case '-':    // NAK
-    case '\x03': // Halt Target
-      end = n + 1;
+  size_t n = 0;
+  while (n < length) {
+    switch (_state) {
+    case kStateIdle:
+      switch (data[n]) {
+      case '+':    // ACK
+      case '-':    // NAK
+      case '\x03': // Halt Target
+        _delegate->onPacketData(data + n, 1, true);
+        n++;
+        break;
+
+      case '$':
+        _state = kStatePayload;
+        _csum = 0;
+        _payloadStart = _payloadEnd = ++n;
+        break;
+
+      default:
+        n = skipInvalidData(data, length, n);
+        break;
+      }
       break;
 
-    case '$':
-    hash:
-      end = data.find('#', n);
-      if (end++ != std::string::npos) {
-        size_t avail = data.length() - end;
-        if (avail < 2) {
-          _buffer += data.substr(n);
-          _nreqs = 2 - avail;
-          return;
-        } else {
-          end += 2;
-        }
+    case kStatePayload: {
+      char const *hash =
+          static_cast<char const *>(std::memchr(data + n, '#', length - n));
+      size_t end = (hash != nullptr) ? hash - data : length;
+
+      for (size_t i = n; i < end; i++) {
+        _csum += data[i];
+      }
+      if (_buffered) {
+        _buffer.append(data + n, end - n);
       } else {
-        _buffer += data.substr(n);
-        _needhash = true;
-        return;
+        _payloadEnd = end;
       }
-      break;
 
-    default:
+      if (hash != nullptr) {
+        _state = kStateChecksum1;
+        end++;
+      }
+      n = end;
+    } break;
+
+    case kStateChecksum1:
+      _validCsum = std::isxdigit(data[n]) != 0;
+      _expectedCsum = _validCsum ? HexToNibble(data[n]) << 4 : 0;
+      _state = kStateChecksum2;
       n++;
-      continue;
-    }
+      break;
 
-    if (end != std::string::npos) {
-      first = std::string::npos;
-      _buffer += data.substr(n, end - n);
-      process();
+    case kStateChecksum2:
+      if (_validCsum) {
+        _validCsum = std::isxdigit(data[n]) != 0;
+        _expectedCsum |= _validCsum ? HexToNibble(data[n]) : 0;
+      }
+      n++;
+      process(data);
+      break;
     }
-    n = end;
   }
 
   //
-  // First is valid when there is data to add.
+  // The packet is incomplete, move what we have of its payload out of the
+  // caller's data before returning.
   //
-  if (first != std::string::npos && first < data.length()) {
-    if (_buffer.empty() && data[first] != '$') {
-      _delegate->onInvalidData(data.substr(first));
-      return;
-    }
-    _buffer += data.substr(first);
+  if (_state != kStateIdle && !_buffered) {
+    _buffer.assign(data + _payloadStart, _payloadEnd - _payloadStart);
+    _buffered = true;
   }
 }
 }
@@ -9,18 +9,16 @@
 //
 
 #include "DebugServer2/GDBRemote/ProtocolHelpers.h"
+#include "DebugServer2/Utils/HexValues.h"
 
+#include <algorithm>
 #include <sstream>
 
 namespace ds2 {
 namespace GDBRemote {
 
 uint8_t Checksum(std::string const &data) {
-  uint8_t csum = 0;
-  for (size_t n = 0; n < data.length(); n++) {
-    csum += data[n];
-  }
-  return csum;
+  return SumBytes(data.data(), data.length());
 }
 
 std::string Escape(std::string const &data) {
@@ -46,6 +44,30 @@ std::string Escape(std::string const &data) {
   return ss.str();
 }
 
+//
+// Returns how many leading bytes of data still fit in size characters once
+// escaped, so that binary replies can be trimmed to the packet size.
+//
+size_t EscapedPrefixLength(std::string const &data, size_t size) {
+  size_t escaped = 0;
+  for (size_t n = 0; n < data.length(); n++) {
+    switch (data[n]) {
+    case '$':
+    case '#':
+    case '}':
+    case '*':
+      escaped += 2;
+      break;
+    default:
+      escaped++;
+      break;
+    }
+    if (escaped > size)
+      return n;
+  }
+  return data.length();
+}
+
 std::string Unescape(std::string const &data) {
   std::ostringstream ss;
   size_t first = 0;
@@ -69,6 +91,110 @@ std::string Unescape(std::string const &data) {
   return ss.str();
 }
 
-std::string Uncompress(std::string const &data) { return Unescape(data); }
+//
+// Run-length encoding: a character followed by '*' and a count character is
+// repeated (count - 29) more times. The count characters '#' and '$' are not
+// allowed, and counts above '~' can't be represented.
+//
+static size_t const kRunLengthBias = 29;
+static size_t const kMaxRunLength = '~' - kRunLengthBias;
+
+//
+// Compresses data that has already been escaped. Escaped characters are never
+// used as the base of a run, as not every decoder repeats the unescaped
+// character.
+//
+std::string Compress(std::string const &data) {
+  std::string result;
+  result.reserve(data.length());
+
+  size_t n = 0;
+  while (n < data.length()) {
+    char c = data[n];
+    result += c;
+
+    if (c == '}') {
+      if (n + 1 < data.length()) {
+        result += data[n + 1];
+      }
+      n += 2;
+      continue;
+    }
+
+    size_t run = 1;
+    while (n + run < data.length() && data[n + run] == c) {
+      run++;
+    }
+    n += run;
+
+    //
+    // The encoding takes two characters so it only pays off for three or
+    // more repeats.
+    //
+    size_t remaining = run - 1;
+    while (remaining >= 3) {
+      size_t count = std::min(remaining, kMaxRunLength);
+      while (count + kRunLengthBias == '#' || count + kRunLengthBias == '$') {
+        count--;
+      }
+      result += '*';
+      result += static_cast<char>(count + kRunLengthBias);
+      remaining -= count;
+
+      if (remaining > 0) {
+        result += c;
+        remaining--;
+      }
+    }
+    result.append(remaining, c);
+  }
+
+  return result;
+}
+
+//
+// Unescapes data and expands its run-length encoding in a single pass, this
+// is the inverse of Escape followed by Compress. A run repeats the decoded
+// character, so "}]* " stands for four '}'.
+//
+std::string Uncompress(std::string const &data) {
+  if (data.find('*') == std::string::npos)
+    return Unescape(data);
+
+  std::string result;
+  result.reserve(data.length());
+  for (size_t n = 0; n < data.length(); n++) {
+    if (data[n] == '}' && n + 1 < data.length()) {
+      result += static_cast<char>(data[++n] + 0x20);
+    } else if (data[n] == '*' && !result.empty() && n + 1 < data.length()) {
+      size_t count = static_cast<uint8_t>(data[++n]);
+      if (count > kRunLengthBias) {
+        result.append(count - kRunLengthBias, result.back());
+      }
+    } else {
+      result += data[n];
+    }
+  }
+
+  return result;
+}
+
+std::string EscapeJSON(std::string const &data) {
+  std::string result;
+  result.reserve(data.length());
+  for (char c : data) {
+    if (c == '"' || c == '\\') {
+      result += '\\';
+      result += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      result += "\\u00";
+      result += NibbleToHex(c >> 4);
+      result += NibbleToHex(c & 15);
+    } else {
+      result += c;
+    }
+  }
+  return result;
+}
 }
 }
@@ -19,16 +19,15 @@
 #include <cstring>
 #include <sstream>
 #include <iomanip>
-#include <algorithm>
 
 using ds2::Host::Platform;
 
 namespace ds2 {
 namespace GDBRemote {
 
-static std::string EscapeForTerm(std::string const &s) {
+static std::string EscapeForTerm(char const *s, size_t length) {
   std::ostringstream ss;
-  for (size_t n = 0; n < s.length(); n++) {
+  for (size_t n = 0; n < length; n++) {
     unsigned c = static_cast<unsigned>(s[n] & 0xff);
     if (c < 0x20 || c > 0x7f) {
       ss << "\\x" << std::hex << std::setw(2) << std::setfill('0') << c
@@ -40,15 +39,23 @@ static std::string EscapeForTerm(std::string const &s) {
   return ss.str();
 }
 
-ProtocolInterpreter::ProtocolInterpreter() : _session(nullptr) {}
+ProtocolInterpreter::ProtocolInterpreter()
+    : _session(nullptr), _handler(nullptr), _lookup(nullptr) {}
 
-void ProtocolInterpreter::onPacketData(std::string const &data, bool valid) {
-  DS2LOG(Remote, Debug, "getpkt(\"%s\")", EscapeForTerm(&data[0]).c_str());
+void ProtocolInterpreter::onPacketData(char const *data, size_t length,
+                                       bool valid) {
+  //
+  // Don't pay for escaping every packet unless it is going to be logged.
+  //
+  if (GetLogLevel() == kLogLevelDebug) {
+    DS2LOG(Remote, Debug, "getpkt(\"%s\")",
+           EscapeForTerm(data, length).c_str());
+  }
 
   if (_session == nullptr)
     return;
 
-  if (data.length() == 1) {
+  if (length == 1) {
     //
     // ACK and NAKs are handled specially.
     //
@@ -78,35 +85,40 @@ void ProtocolInterpreter::onPacketData(std::string const &data, bool valid) {
   // Extract the command and arguments to pass down to the
   // handler.
   //
+  char first = (length != 0) ? data[0] : '\0';
   size_t command_end = std::string::npos;
   size_t args_start = std::string::npos;
-  if (data[0] == 'v' || data[0] == 'q' || data[0] == 'Q') {
+  if (first == 'v' || first == 'q' || first == 'Q' || first == 'j') {
     //
-    // The commands starting with 'v', 'q' or 'Q' may be terminated
+    // The commands starting with 'v', 'q', 'Q' or 'j' may be terminated
     // by one of the following separator: , (comma), : (colon) or
     // ; (semi-colon).
     //
-    size_t end = data.find_first_of(",:;");
-    if (end != std::string::npos) {
-      command_end = end;
+    size_t end = 0;
+    while (end < length && data[end] != ',' && data[end] != ':' &&
+           data[end] != ';') {
+      end++;
+    }
+    command_end = end;
+    if (end < length) {
       args_start = end + 1;
     }
-  } else if (data[0] == 'b') {
+  } else if (first == 'b') {
     //
     // The commands starting with 'b' may be two chars long; only 'bc'
     // and 'bs' are known.
     //
-    if (data.length() == 2 && (data[1] == 'c' || data[1] == 's')) {
+    if (length == 2 && (data[1] == 'c' || data[1] == 's')) {
       command_end = 2;
     } else {
       command_end = 1;
     }
-  } else if (data[0] == '_') {
+  } else if (first == '_') {
     //
     // The commands starting with '_' may be two chars long; only '_M'
     // and '_m' are known.
     //
-    if (data.length() > 1 && (data[1] == 'M' || data[1] == 'm')) {
+    if (length > 1 && (data[1] == 'M' || data[1] == 'm')) {
       command_end = 2;
     } else {
       command_end = 1;
@@ -115,44 +127,39 @@ void ProtocolInterpreter::onPacketData(std::string const &data, bool valid) {
     //
     // Any other command is long just one char.
     //
-    command_end = 1;
+    command_end = (length != 0) ? 1 : 0;
   }
 
-  if (args_start == std::string::npos && command_end < data.length()) {
+  if (args_start == std::string::npos) {
     //
     // Arguments follow the command with no separator.
     //
     args_start = command_end;
   }
 
-  std::string command = data.substr(0, command_end);
-  std::string args;
-  if (args_start != std::string::npos) {
-    args = data.substr(args_start);
-  }
-
   //
   // Find the handler and execute it.
   //
-  onCommand(command, args);
+  onCommand(data, length, command_end, args_start);
 }
 
-void ProtocolInterpreter::onInvalidData(std::string const &data) {
-  DS2LOG(Protocol, Warning, "received invalid data: '%s'", data.c_str());
+void ProtocolInterpreter::onInvalidData(char const *data, size_t length) {
+  DS2LOG(Protocol, Warning, "received invalid data: '%.*s'",
+         static_cast<int>(length), data);
 
   if (_session == nullptr)
     return;
 
-  _session->onInvalidData(data);
+  _session->onInvalidData(std::string(data, length));
 }
 
-void ProtocolInterpreter::onCommand(std::string const &command,
-                                    std::string const &arguments) {
-  size_t commandLength;
-  Handler const *handler = findHandler(command, commandLength);
+void ProtocolInterpreter::onCommand(char const *data, size_t length,
+                                    size_t commandEnd, size_t argsStart) {
+  Handler const *handler =
+      (_lookup != nullptr) ? _lookup(data, commandEnd) : nullptr;
   if (handler == nullptr) {
-    DS2LOG(Protocol, Debug, "handler for command '%s' unknown",
-           command.c_str());
+    DS2LOG(Protocol, Debug, "handler for command '%.*s' unknown",
+           static_cast<int>(commandEnd), data);
 
     //
     // The handler couldn't be found, send a NAK.
@@ -161,73 +168,50 @@ void ProtocolInterpreter::onCommand(std::string const &command,
     return;
   }
 
-  std::string extra;
-  if (commandLength != command.length()) {
+  //
+  // The arguments are copied into a buffer owned by the interpreter so that
+  // its storage gets reused from one command to the next.
+  //
+  _arguments.clear();
+  if (handler->length != commandEnd) {
     //
     // Command has part of the argument, LLDB doesn't use separators :(
     //
-    extra = command.substr(commandLength);
+    _arguments.append(data + handler->length, commandEnd - handler->length);
   }
 
-  extra += arguments;
+  _arguments.append(data + argsStart, length - argsStart);
 
-  if (extra.find_first_of("*}") != std::string::npos) {
-    extra = Uncompress(extra);
-    DS2LOG(Protocol, Debug, "args='%.*s'", static_cast<int>(extra.length()),
-           &extra[0]);
+  if (_arguments.find_first_of("*}") != std::string::npos) {
+    _arguments = Uncompress(_arguments);
+    DS2LOG(Protocol, Debug, "args='%.*s'",
+           static_cast<int>(_arguments.length()), &_arguments[0]);
   }
 
 #if 0
-    DS2LOG(Protocol, Debug, "command='%s' arguments='%s'\n",
-            command.substr(0, commandLength).c_str(),
-            extra.c_str());
+    DS2LOG(Protocol, Debug, "command='%.*s' arguments='%s'\n",
+            static_cast<int>(handler->length), data,
+            _arguments.c_str());
 #endif
 
-  (handler->handler->*handler->callback)(*handler, extra);
+  (_handler->*handler->callback)(*handler, _arguments);
 }
 
-bool ProtocolInterpreter::registerHandler(Handler const &handler) {
-  if (handler.command.empty() || handler.handler == nullptr ||
-      handler.callback == nullptr)
-    return false;
-
-  size_t commandLength;
-  if (findHandler(handler.command, commandLength))
+bool ProtocolInterpreter::Handler::matches(char const *command,
+                                           size_t length) const {
+  if (this->mode == Handler::kModeStartsWith ? length < this->length
+                                             : length != this->length)
     return false;
-
-  _handlers.push_back(handler);
-
-  // We need to sort the handlers vector.
-  std::sort(_handlers.begin(), _handlers.end(),
-            [](Handler const &a, Handler const &b)
-                -> bool { return (a.command < b.command); });
-
-  return true;
+  return std::memcmp(this->command, command, this->length) == 0;
 }
 
-ProtocolInterpreter::Handler const *
-ProtocolInterpreter::findHandler(std::string const &command,
-                                 size_t &commandLength) const {
-  auto it =
-      std::lower_bound(_handlers.begin(), _handlers.end(), command,
-                       [](Handler const &handler, std::string const &command)
-                           -> bool { return handler.compare(command) < 0; });
-
-  Handler const *handler = nullptr;
-  if (it != _handlers.end() && it->compare(command) == 0) {
-    commandLength = it->command.length();
-    handler = &(*it);
-  }
-
-  return handler;
-}
-
-int ProtocolInterpreter::Handler::compare(std::string const &command) const {
-  if (this->mode == Handler::kModeEquals) {
-    return this->command.compare(command);
-  } else {
-    return this->command.compare(command.substr(0, this->command.length()));
+uint32_t ProtocolInterpreter::Handler::Hash(char const *command,
+                                            size_t length) {
+  uint32_t hash = 2166136261u;
+  for (size_t n = 0; n < length; n++) {
+    hash = (hash ^ static_cast<uint8_t>(command[n])) * 16777619u;
   }
+  return hash;
 }
 }
 }
@@ -17,9 +17,11 @@
 #include "DebugServer2/Utils/Log.h"
 #include "DebugServer2/Utils/SwapEndian.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <iomanip>
+#include <limits>
 #include <sstream>
 
 #if defined(__linux__)
@@ -33,140 +35,183 @@
 namespace ds2 {
 namespace GDBRemote {
 
-Session::Session(CompatibilityMode mode) : _compatMode(mode) {
-#define REGISTER_HANDLER_EQUALS_2(MESSAGE, HANDLER)                            \
-  interpreter().registerHandler(ProtocolInterpreter::Handler::kModeEquals,     \
-                                MESSAGE, this, &Session::Handle_##HANDLER);
-#define REGISTER_HANDLER_EQUALS_1(HANDLER)                                     \
-  REGISTER_HANDLER_EQUALS_2(#HANDLER, HANDLER)
-
-#define REGISTER_HANDLER_STARTS_WITH_2(MESSAGE, HANDLER)                       \
-  interpreter().registerHandler(ProtocolInterpreter::Handler::kModeStartsWith, \
-                                MESSAGE, this, &Session::Handle_##HANDLER);
-#define REGISTER_HANDLER_STARTS_WITH_1(HANDLER)                                \
-  REGISTER_HANDLER_STARTS_WITH_2(#HANDLER, HANDLER)
-
-  REGISTER_HANDLER_EQUALS_2("\x03", ControlC);
-  REGISTER_HANDLER_EQUALS_2("?", QuestionMark);
-  REGISTER_HANDLER_EQUALS_2("!", ExclamationMark);
-
-  REGISTER_HANDLER_EQUALS_1(A);
-  REGISTER_HANDLER_EQUALS_1(B);
-  REGISTER_HANDLER_EQUALS_1(b);
-  REGISTER_HANDLER_EQUALS_1(bc);
-  REGISTER_HANDLER_EQUALS_1(bs);
-  REGISTER_HANDLER_EQUALS_1(C);
-  REGISTER_HANDLER_EQUALS_1(c);
-  REGISTER_HANDLER_EQUALS_1(D);
-  REGISTER_HANDLER_EQUALS_1(d);
-  // REGISTER_HANDLER_EQUALS_1(F);
-  REGISTER_HANDLER_EQUALS_1(G);
-  REGISTER_HANDLER_EQUALS_1(g);
-  REGISTER_HANDLER_EQUALS_1(H);
-  REGISTER_HANDLER_EQUALS_1(I);
-  REGISTER_HANDLER_EQUALS_1(i);
-  REGISTER_HANDLER_EQUALS_1(k);
-  REGISTER_HANDLER_EQUALS_1(_M);
-  REGISTER_HANDLER_EQUALS_1(_m);
-  REGISTER_HANDLER_EQUALS_1(M);
-  REGISTER_HANDLER_EQUALS_1(m);
-  REGISTER_HANDLER_EQUALS_1(P);
-  REGISTER_HANDLER_EQUALS_1(p);
-  REGISTER_HANDLER_EQUALS_1(QAgent);
-  REGISTER_HANDLER_EQUALS_1(QAllow);
-  REGISTER_HANDLER_EQUALS_1(QDisableRandomization);
-  REGISTER_HANDLER_EQUALS_1(QEnvironment);
-  REGISTER_HANDLER_EQUALS_1(QEnvironmentHexEncoded);
-  REGISTER_HANDLER_EQUALS_1(QLaunchArch);
-  REGISTER_HANDLER_EQUALS_1(QListThreadsInStopReply);
-  REGISTER_HANDLER_EQUALS_1(QNonStop);
-  REGISTER_HANDLER_EQUALS_1(QPassSignals);
-  REGISTER_HANDLER_EQUALS_1(QProgramSignals);
-  REGISTER_HANDLER_EQUALS_1(QRestoreRegisterState);
-  REGISTER_HANDLER_EQUALS_1(QSaveRegisterState);
-  REGISTER_HANDLER_EQUALS_1(QSetDisableASLR);
-  REGISTER_HANDLER_EQUALS_1(QSetEnableAsyncProfiling);
-  REGISTER_HANDLER_EQUALS_1(QSetLogging);
-  REGISTER_HANDLER_EQUALS_1(QSetMaxPacketSize);
-  REGISTER_HANDLER_EQUALS_1(QSetMaxPayloadSize);
-  REGISTER_HANDLER_EQUALS_1(QSetSTDERR);
-  REGISTER_HANDLER_EQUALS_1(QSetSTDIN);
-  REGISTER_HANDLER_EQUALS_1(QSetSTDOUT);
-  REGISTER_HANDLER_EQUALS_1(QSetWorkingDir);
-  REGISTER_HANDLER_EQUALS_1(QStartNoAckMode);
-  REGISTER_HANDLER_EQUALS_1(QSyncThreadState);
-  REGISTER_HANDLER_EQUALS_1(QThreadSuffixSupported);
-  REGISTER_HANDLER_EQUALS_1(Qbtrace);
-  REGISTER_HANDLER_EQUALS_1(qAttached);
-  REGISTER_HANDLER_EQUALS_1(qC);
-  REGISTER_HANDLER_EQUALS_1(qCRC);
-  REGISTER_HANDLER_EQUALS_1(qGDBServerVersion);
-  REGISTER_HANDLER_EQUALS_1(qGetPid);
-  REGISTER_HANDLER_EQUALS_1(qGetProfileData);
-  REGISTER_HANDLER_EQUALS_1(qGetTIBAddr);
-  REGISTER_HANDLER_EQUALS_1(qGetTLSAddr);
-  REGISTER_HANDLER_EQUALS_1(qGetWorkingDir);
-  REGISTER_HANDLER_EQUALS_1(qGroupName);
-  REGISTER_HANDLER_EQUALS_1(qHostInfo);
-  REGISTER_HANDLER_EQUALS_1(qKillSpawnedProcess);
-  REGISTER_HANDLER_EQUALS_1(qL);
-  REGISTER_HANDLER_EQUALS_1(qLaunchGDBServer);
-  REGISTER_HANDLER_EQUALS_1(qLaunchSuccess);
-  REGISTER_HANDLER_EQUALS_1(qMemoryRegionInfo);
-  REGISTER_HANDLER_EQUALS_1(qOffsets);
-  REGISTER_HANDLER_EQUALS_1(qP);
-  REGISTER_HANDLER_EQUALS_1(qPlatform_IO_MkDir);
-  REGISTER_HANDLER_EQUALS_1(qPlatform_RunCommand);
-  REGISTER_HANDLER_EQUALS_1(qProcessInfo);
-  REGISTER_HANDLER_EQUALS_1(qProcessInfoPID);
-  REGISTER_HANDLER_EQUALS_1(qRcmd);
-  REGISTER_HANDLER_STARTS_WITH_1(qRegisterInfo);
-  REGISTER_HANDLER_EQUALS_1(qSearch);
-  REGISTER_HANDLER_EQUALS_1(qShlibInfoAddr);
-  REGISTER_HANDLER_EQUALS_1(qSpeedTest);
-  REGISTER_HANDLER_EQUALS_1(qStepPacketSupported);
-  REGISTER_HANDLER_EQUALS_1(qSupported);
-  REGISTER_HANDLER_EQUALS_1(qSupportsDetachAndStayStopped);
-  REGISTER_HANDLER_EQUALS_1(qSymbol);
-  REGISTER_HANDLER_STARTS_WITH_1(qThreadStopInfo);
-  REGISTER_HANDLER_EQUALS_1(qThreadExtraInfo);
-  REGISTER_HANDLER_EQUALS_1(qTStatus);
-  REGISTER_HANDLER_EQUALS_1(qUserName);
-  REGISTER_HANDLER_EQUALS_1(qVAttachOrWaitSupported);
-  REGISTER_HANDLER_EQUALS_1(qWatchpointSupportInfo);
-  REGISTER_HANDLER_EQUALS_1(qXfer);
-  REGISTER_HANDLER_EQUALS_1(qfProcessInfo);
-  REGISTER_HANDLER_EQUALS_1(qsProcessInfo);
-  REGISTER_HANDLER_EQUALS_1(qfThreadInfo);
-  REGISTER_HANDLER_EQUALS_1(qsThreadInfo);
-  REGISTER_HANDLER_EQUALS_1(R);
-  REGISTER_HANDLER_EQUALS_1(r);
-  REGISTER_HANDLER_EQUALS_1(S);
-  REGISTER_HANDLER_EQUALS_1(s);
-  REGISTER_HANDLER_EQUALS_1(T);
-  REGISTER_HANDLER_EQUALS_1(t);
-  REGISTER_HANDLER_EQUALS_1(vAttach);
-  REGISTER_HANDLER_EQUALS_1(vAttachName);
-  REGISTER_HANDLER_EQUALS_1(vAttachWait);
-  REGISTER_HANDLER_EQUALS_1(vAttachOrWait);
-  REGISTER_HANDLER_EQUALS_2("vCont?", vContQuestionMark);
-  REGISTER_HANDLER_EQUALS_1(vCont);
-  REGISTER_HANDLER_EQUALS_1(vFile);
-  REGISTER_HANDLER_EQUALS_1(vFlashDone);
-  REGISTER_HANDLER_EQUALS_1(vFlashErase);
-  REGISTER_HANDLER_EQUALS_1(vFlashWrite);
-  REGISTER_HANDLER_EQUALS_1(vKill);
-  REGISTER_HANDLER_EQUALS_1(vRun);
-  REGISTER_HANDLER_EQUALS_1(vStopped);
-  REGISTER_HANDLER_EQUALS_1(X);
-  REGISTER_HANDLER_EQUALS_1(x);
-  REGISTER_HANDLER_EQUALS_1(Z);
-  REGISTER_HANDLER_EQUALS_1(z);
-
-#undef REGISTER_HANDLER_STARTS_WITH_1
-#undef REGISTER_HANDLER_STARTS_WITH_2
-#undef REGISTER_HANDLER_EQUALS_1
-#undef REGISTER_HANDLER_EQUALS_2
+Session::Session(CompatibilityMode mode)
+    : _compatMode(mode), _listThreadsInStopReply(false) {
+  interpreter().setHandlers(this, &Session::FindHandler);
+}
+
+//
+// The handler table is laid out at compile time: commands are dispatched by
+// switching on the hash of their name, a collision between two of them is a
+// duplicate case label, and the strings are still compared since packets can
+// contain anything.
+//
+ProtocolInterpreter::Handler const *Session::FindHandler(char const *command,
+                                                         size_t length) {
+  typedef ProtocolInterpreter::Handler Handler;
+
+#define HANDLER_ENTRY(MODE, MESSAGE, HANDLER)                                  \
+  {                                                                            \
+    Handler::MODE, MESSAGE, sizeof(MESSAGE) - 1,                               \
+        static_cast<Handler::Callback>(&Session::Handle_##HANDLER)             \
+  }
+
+#define HANDLER_EQUALS_2(MESSAGE, HANDLER)                                     \
+  case Handler::ConstHash(MESSAGE, sizeof(MESSAGE) - 1): {                     \
+    static Handler const handler =                                             \
+        HANDLER_ENTRY(kModeEquals, MESSAGE, HANDLER);                          \
+    if (handler.matches(command, length))                                      \
+      return &handler;                                                         \
+    break;                                                                     \
+  }
+#define HANDLER_EQUALS_1(HANDLER) HANDLER_EQUALS_2(#HANDLER, HANDLER)
+
+#define HANDLER_STARTS_WITH_2(MESSAGE, HANDLER)                                \
+  HANDLER_ENTRY(kModeStartsWith, MESSAGE, HANDLER)
+#define HANDLER_STARTS_WITH_1(HANDLER) HANDLER_STARTS_WITH_2(#HANDLER, HANDLER)
+
+  switch (Handler::Hash(command, length)) {
+    HANDLER_EQUALS_2("\x03", ControlC)
+    HANDLER_EQUALS_2("?", QuestionMark)
+    HANDLER_EQUALS_2("!", ExclamationMark)
+    HANDLER_EQUALS_1(A)
+    HANDLER_EQUALS_1(B)
+    HANDLER_EQUALS_1(b)
+    HANDLER_EQUALS_1(bc)
+    HANDLER_EQUALS_1(bs)
+    HANDLER_EQUALS_1(C)
+    HANDLER_EQUALS_1(c)
+    HANDLER_EQUALS_1(D)
+    HANDLER_EQUALS_1(d)
+    // HANDLER_EQUALS_1(F)
+    HANDLER_EQUALS_1(G)
+    HANDLER_EQUALS_1(g)
+    HANDLER_EQUALS_1(H)
+    HANDLER_EQUALS_1(I)
+    HANDLER_EQUALS_1(i)
+    HANDLER_EQUALS_1(jMemoryRegions)
+    HANDLER_EQUALS_1(jMultiMemRead)
+    HANDLER_EQUALS_1(jThreadsInfo)
+    HANDLER_EQUALS_1(k)
+    HANDLER_EQUALS_1(_M)
+    HANDLER_EQUALS_1(_m)
+    HANDLER_EQUALS_1(M)
+    HANDLER_EQUALS_1(m)
+    HANDLER_EQUALS_1(P)
+    HANDLER_EQUALS_1(p)
+    HANDLER_EQUALS_1(QAgent)
+    HANDLER_EQUALS_1(QAllow)
+    HANDLER_EQUALS_1(QDisableRandomization)
+    HANDLER_EQUALS_1(QEnvironment)
+    HANDLER_EQUALS_1(QEnvironmentHexEncoded)
+    HANDLER_EQUALS_1(QLaunchArch)
+    HANDLER_EQUALS_1(QListThreadsInStopReply)
+    HANDLER_EQUALS_1(QNonStop)
+    HANDLER_EQUALS_1(QPassSignals)
+    HANDLER_EQUALS_1(QProgramSignals)
+    HANDLER_EQUALS_1(QRestoreRegisterState)
+    HANDLER_EQUALS_1(QSaveRegisterState)
+    HANDLER_EQUALS_1(QSetDisableASLR)
+    HANDLER_EQUALS_1(QSetEnableAsyncProfiling)
+    HANDLER_EQUALS_1(QSetLogging)
+    HANDLER_EQUALS_1(QSetMaxPacketSize)
+    HANDLER_EQUALS_1(QSetMaxPayloadSize)
+    HANDLER_EQUALS_1(QSetSTDERR)
+    HANDLER_EQUALS_1(QSetSTDIN)
+    HANDLER_EQUALS_1(QSetSTDOUT)
+    HANDLER_EQUALS_1(QSetWorkingDir)
+    HANDLER_EQUALS_1(QStartNoAckMode)
+    HANDLER_EQUALS_1(QSyncThreadState)
+    HANDLER_EQUALS_1(QThreadSuffixSupported)
+    HANDLER_EQUALS_1(Qbtrace)
+    HANDLER_EQUALS_1(qAttached)
+    HANDLER_EQUALS_1(qC)
+    HANDLER_EQUALS_1(qCRC)
+    HANDLER_EQUALS_1(qGDBServerVersion)
+    HANDLER_EQUALS_1(qGetPid)
+    HANDLER_EQUALS_1(qGetProfileData)
+    HANDLER_EQUALS_1(qGetTIBAddr)
+    HANDLER_EQUALS_1(qGetTLSAddr)
+    HANDLER_EQUALS_1(qGetWorkingDir)
+    HANDLER_EQUALS_1(qGroupName)
+    HANDLER_EQUALS_1(qHostInfo)
+    HANDLER_EQUALS_1(qKillSpawnedProcess)
+    HANDLER_EQUALS_1(qL)
+    HANDLER_EQUALS_1(qLaunchGDBServer)
+    HANDLER_EQUALS_1(qLaunchSuccess)
+    HANDLER_EQUALS_1(qMemoryRegionInfo)
+    HANDLER_EQUALS_1(qOffsets)
+    HANDLER_EQUALS_1(qP)
+    HANDLER_EQUALS_1(qPlatform_IO_MkDir)
+    HANDLER_EQUALS_1(qPlatform_RunCommand)
+    HANDLER_EQUALS_1(qProcessInfo)
+    HANDLER_EQUALS_1(qProcessInfoPID)
+    HANDLER_EQUALS_1(qRcmd)
+    HANDLER_EQUALS_1(qSearch)
+    HANDLER_EQUALS_1(qShlibInfoAddr)
+    HANDLER_EQUALS_1(qSpeedTest)
+    HANDLER_EQUALS_1(qStepPacketSupported)
+    HANDLER_EQUALS_1(qSupported)
+    HANDLER_EQUALS_1(qSupportsDetachAndStayStopped)
+    HANDLER_EQUALS_1(qSymbol)
+    HANDLER_EQUALS_1(qThreadExtraInfo)
+    HANDLER_EQUALS_1(qTStatus)
+    HANDLER_EQUALS_1(qUserName)
+    HANDLER_EQUALS_1(qVAttachOrWaitSupported)
+    HANDLER_EQUALS_1(qWatchpointSupportInfo)
+    HANDLER_EQUALS_1(qXfer)
+    HANDLER_EQUALS_1(qfProcessInfo)
+    HANDLER_EQUALS_1(qsProcessInfo)
+    HANDLER_EQUALS_1(qfThreadInfo)
+    HANDLER_EQUALS_1(qsThreadInfo)
+    HANDLER_EQUALS_1(R)
+    HANDLER_EQUALS_1(r)
+    HANDLER_EQUALS_1(S)
+    HANDLER_EQUALS_1(s)
+    HANDLER_EQUALS_1(T)
+    HANDLER_EQUALS_1(t)
+    HANDLER_EQUALS_1(vAttach)
+    HANDLER_EQUALS_1(vAttachName)
+    HANDLER_EQUALS_1(vAttachWait)
+    HANDLER_EQUALS_1(vAttachOrWait)
+    HANDLER_EQUALS_2("vCont?", vContQuestionMark)
+    HANDLER_EQUALS_1(vCont)
+    HANDLER_EQUALS_1(vFile)
+    HANDLER_EQUALS_1(vFlashDone)
+    HANDLER_EQUALS_1(vFlashErase)
+    HANDLER_EQUALS_1(vFlashWrite)
+    HANDLER_EQUALS_1(vKill)
+    HANDLER_EQUALS_1(vRun)
+    HANDLER_EQUALS_1(vStopped)
+    HANDLER_EQUALS_1(X)
+    HANDLER_EQUALS_1(x)
+    HANDLER_EQUALS_1(Z)
+    HANDLER_EQUALS_1(z)
+  default:
+    break;
+  }
+
+  //
+  // The few commands that take their argument without a separator can't be
+  // hashed whole and are matched on their prefix instead.
+  //
+  static Handler const prefixHandlers[] = {
+      HANDLER_STARTS_WITH_1(qRegisterInfo),
+      HANDLER_STARTS_WITH_1(qThreadStopInfo),
+  };
+
+  for (auto const &handler : prefixHandlers) {
+    if (handler.matches(command, length))
+      return &handler;
+  }
+
+  return nullptr;
+
+#undef HANDLER_STARTS_WITH_1
+#undef HANDLER_STARTS_WITH_2
+#undef HANDLER_EQUALS_1
+#undef HANDLER_EQUALS_2
+#undef HANDLER_ENTRY
 }
 
 bool Session::ParseList(std::string const &string, char separator,
@@ -829,6 +874,155 @@ void Session::Handle_i(ProtocolInterpreter::Handler const &,
   }
 }
 
+//
+// Packet:        jMemoryRegions[:offset,length]
+// Description:   Lists every mapped region of the inferior as a JSON array
+//                of objects with start, size, permissions and name keys.
+//                The document can be transferred in chunks like a qXfer
+//                object; the reply is prefixed with 'm' if more data
+//                follows and 'l' otherwise.
+// Compatibility: LLDB
+//
+void Session::Handle_jMemoryRegions(ProtocolInterpreter::Handler const &,
+                                    std::string const &args) {
+  uint64_t offset = 0;
+  uint64_t length = std::numeric_limits<uint64_t>::max();
+
+  if (!args.empty()) {
+    char *eptr;
+    offset = strtoull(args.c_str(), &eptr, 16);
+    if (*eptr++ != ',') {
+      sendError(kErrorInvalidArgument);
+      return;
+    }
+    length = strtoull(eptr, nullptr, 16);
+  }
+
+  bool last = true;
+  std::string buffer;
+
+  ErrorCode error = _delegate->onXferRead(*this, "memory-regions", "", offset,
+                                          length, buffer, last);
+  if (error != kSuccess) {
+    sendError(error);
+    return;
+  }
+
+  send((last || buffer.empty() ? "l" : "m") + buffer);
+}
+
+//
+// Packet:        jMultiMemRead:ranges:addr,length[,addr,length]...[;]
+// Description:   Read several ranges of target memory with a single packet.
+//                The reply lists, for each range in request order, the
+//                number of bytes read (or an error code) followed by the
+//                binary data of all ranges concatenated:
+//                  length-or-Exx[,length-or-Exx]...;data
+//                Ranges are read short once the reply would exceed the
+//                packet size.
+// Compatibility: LLDB
+//
+void Session::Handle_jMultiMemRead(ProtocolInterpreter::Handler const &,
+                                   std::string const &args) {
+  static std::string const kRangesPrefix = "ranges:";
+
+  if (args.compare(0, kRangesPrefix.length(), kRangesPrefix) != 0) {
+    sendError(kErrorInvalidArgument);
+    return;
+  }
+
+  MemoryRange::Collection ranges;
+  char const *ptr = args.c_str() + kRangesPrefix.length();
+  while (*ptr != '\0' && *ptr != ';') {
+    char *eptr;
+    uint64_t address = strtoull(ptr, &eptr, 16);
+    if (eptr == ptr || *eptr++ != ',') {
+      sendError(kErrorInvalidArgument);
+      return;
+    }
+    ptr = eptr;
+    uint64_t length = strtoull(ptr, &eptr, 16);
+    if (eptr == ptr || (*eptr != ',' && *eptr != ';' && *eptr != '\0')) {
+      sendError(kErrorInvalidArgument);
+      return;
+    }
+    ptr = (*eptr == ',') ? eptr + 1 : eptr;
+
+    ranges.push_back(MemoryRange(address, length));
+  }
+
+  //
+  // Each range is reported with at most 16 digits and a separator, what is
+  // left of the packet is shared by the data of all the ranges, in request
+  // order.
+  //
+  size_t header = ranges.size() * 17 + 1;
+  if (ranges.empty() || header >= packetSize()) {
+    sendError(kErrorInvalidArgument);
+    return;
+  }
+
+  size_t budget = packetSize() - header;
+  size_t remaining = budget;
+  for (auto &range : ranges) {
+    range.length = std::min<uint64_t>(range.length, remaining);
+    range.length = std::min<uint64_t>(
+        range.length, std::numeric_limits<uint64_t>::max() - range.start.value());
+    remaining -= range.length;
+  }
+
+  ErrorCode error = _delegate->onReadMemory(*this, ranges);
+  if (error != kSuccess) {
+    sendError(error);
+    return;
+  }
+
+  //
+  // Escaping may grow the data, so ranges are trimmed again as they are
+  // escaped and report how much of them was sent.
+  //
+  std::ostringstream ss;
+  std::string data;
+  remaining = budget;
+  for (size_t n = 0; n < ranges.size(); n++) {
+    if (n != 0) {
+      ss << ',';
+    }
+    if (ranges[n].error != kSuccess) {
+      ss << 'E' << NibbleToHex(ranges[n].error >> 4)
+         << NibbleToHex(ranges[n].error & 15);
+    } else {
+      size_t length = EscapedPrefixLength(ranges[n].data, remaining);
+      std::string escaped = Escape(ranges[n].data.substr(0, length));
+      ss << std::hex << length;
+      data += escaped;
+      remaining -= escaped.length();
+    }
+  }
+  ss << ';';
+
+  send(ss.str() + data, true);
+}
+
+//
+// Packet:        jThreadsInfo
+// Description:   Get the stop information of all threads at once, as a JSON
+//                array of objects holding the thread id, name, stop reason,
+//                signal, core and expedited registers of each thread.
+// Compatibility: LLDB
+//
+void Session::Handle_jThreadsInfo(ProtocolInterpreter::Handler const &,
+                                  std::string const &) {
+  ErrorCode error =
+      _delegate->onQueryThreadsInfo(*this, kAnyProcessId, _threadsInfoBuffer);
+  if (error != kSuccess) {
+    sendError(error);
+    return;
+  }
+
+  send(_threadsInfoBuffer);
+}
+
 //
 // Packet:        k
 // Description:   Kill target
@@ -930,9 +1124,18 @@ void Session::Handle_M(ProtocolInterpreter::Handler const &,
     return;
   }
 
-  std::string data(HexToString(eptr));
-  if (data.length() > length) {
-    data = data.substr(0, length);
+  //
+  // Don't decode more than what is going to be written.
+  //
+  size_t ndigits = args.length() - (eptr - args.c_str());
+  if (ndigits > length * 2) {
+    ndigits = length * 2;
+  }
+
+  std::string data;
+  if (!HexToString(eptr, ndigits, data)) {
+    sendError(kErrorInvalidArgument);
+    return;
   }
 
   size_t nwritten = 0;
@@ -958,6 +1161,13 @@ void Session::Handle_m(ProtocolInterpreter::Handler const &,
   }
   length = strtoull(eptr, nullptr, 16);
 
+  //
+  // Each byte takes two characters, clients handle short reads.
+  //
+  if (length > packetSize() / 2) {
+    length = packetSize() / 2;
+  }
+
   ErrorCode error = _delegate->onReadMemory(*this, address, length, data);
   if (error != kSuccess) {
     sendError(error);
@@ -992,7 +1202,10 @@ void Session::Handle_P(ProtocolInterpreter::Handler const &,
     ptidptr = std::strchr(eptr, '\0');
   }
 
-  value = HexToString(std::string(eptr, ptidptr - eptr));
+  if (!HexToString(std::string(eptr, ptidptr - eptr), value)) {
+    sendError(kErrorInvalidArgument);
+    return;
+  }
 
   if (_compatMode == kCompatibilityModeLLDB) {
     //
@@ -1080,7 +1293,12 @@ void Session::Handle_QEnvironment(ProtocolInterpreter::Handler const &,
 void
 Session::Handle_QEnvironmentHexEncoded(ProtocolInterpreter::Handler const &,
                                        std::string const &args) {
-  std::string key, value, ev(HexToString(args));
+  std::string key, value, ev;
+  if (!HexToString(args, ev)) {
+    sendError(kErrorInvalidArgument);
+    return;
+  }
+
 
   size_t eq = ev.find('=');
   if (eq != std::string::npos) {
@@ -1274,12 +1492,13 @@ void Session::Handle_QDisableRandomization(ProtocolInterpreter::Handler const &,
 void Session::Handle_QSetMaxPacketSize(ProtocolInterpreter::Handler const &,
                                        std::string const &args) {
   uint32_t size = std::strtoul(args.c_str(), nullptr, 16);
-  if (size == 0) {
+  if (size < kMinimumPacketSize) {
     sendError(kErrorInvalidArgument);
     return;
   }
 
-  sendError(_delegate->onSetMaxPacketSize(*this, size));
+  setPacketSize(size);
+  sendOK();
 }
 
 //
@@ -1291,12 +1510,13 @@ void Session::Handle_QSetMaxPacketSize(ProtocolInterpreter::Handler const &,
 void Session::Handle_QSetMaxPayloadSize(ProtocolInterpreter::Handler const &,
                                         std::string const &args) {
   uint32_t size = std::strtoul(args.c_str(), nullptr, 16);
-  if (size == 0) {
+  if (size < kMinimumPacketSize) {
     sendError(kErrorInvalidArgument);
     return;
   }
 
-  sendError(_delegate->onSetMaxPayloadSize(*this, size));
+  setPacketSize(size);
+  sendOK();
 }
 
 //
@@ -1306,7 +1526,13 @@ void Session::Handle_QSetMaxPayloadSize(ProtocolInterpreter::Handler const &,
 //
 void Session::Handle_QSetSTDERR(ProtocolInterpreter::Handler const &,
                                 std::string const &args) {
-  sendError(_delegate->onSetStdFile(*this, 2, HexToString(args)));
+  std::string path;
+  if (!HexToString(args, path)) {
+    sendError(kErrorInvalidArgument);
+    return;
+  }
+
+  sendError(_delegate->onSetStdFile(*this, 2, path));
 }
 
 //
@@ -1316,7 +1542,13 @@ void Session::Handle_QSetSTDERR(ProtocolInterpreter::Handler const &,
 //
 void Session::Handle_QSetSTDIN(ProtocolInterpreter::Handler const &,
                                std::string const &args) {
-  sendError(_delegate->onSetStdFile(*this, 0, HexToString(args)));
+  std::string path;
+  if (!HexToString(args, path)) {
+    sendError(kErrorInvalidArgument);
+    return;
+  }
+
+  sendError(_delegate->onSetStdFile(*this, 0, path));
 }
 
 //
@@ -1326,7 +1558,13 @@ void Session::Handle_QSetSTDIN(ProtocolInterpreter::Handler const &,
 //
 void Session::Handle_QSetSTDOUT(ProtocolInterpreter::Handler const &,
                                 std::string const &args) {
-  sendError(_delegate->onSetStdFile(*this, 1, HexToString(args)));
+  std::string path;
+  if (!HexToString(args, path)) {
+    sendError(kErrorInvalidArgument);
+    return;
+  }
+
+  sendError(_delegate->onSetStdFile(*this, 1, path));
 }
 
 //
@@ -1336,7 +1574,13 @@ void Session::Handle_QSetSTDOUT(ProtocolInterpreter::Handler const &,
 //
 void Session::Handle_QSetWorkingDir(ProtocolInterpreter::Handler const &,
                                     std::string const &args) {
-  sendError(_delegate->onSetWorkingDirectory(*this, HexToString(args)));
+  std::string path;
+  if (!HexToString(args, path)) {
+    sendError(kErrorInvalidArgument);
+    return;
+  }
+
+  sendError(_delegate->onSetWorkingDirectory(*this, path));
 }
 
 //
@@ -1364,6 +1608,7 @@ Session::Handle_QListThreadsInStopReply(ProtocolInterpreter::Handler const &,
     _compatMode = kCompatibilityModeLLDB;
   }
 
+  _listThreadsInStopReply = true;
   sendOK();
 }
 
@@ -1723,9 +1968,9 @@ void Session::Handle_qL(ProtocolInterpreter::Handler const &,
 
   ThreadId next = std::strtoul(&args[2], nullptr, 16);
 
-  ThreadId tid;
+  std::vector<ThreadId> tids;
   ErrorCode error =
-      _delegate->onQueryThreadList(*this, kAnyProcessId, next, tid);
+      _delegate->onQueryThreadList(*this, kAnyProcessId, next, 1, tids);
   if (error != kSuccess && error != kErrorNotFound) {
     sendError(error);
     return;
@@ -1742,7 +1987,7 @@ void Session::Handle_qL(ProtocolInterpreter::Handler const &,
     ss << '1'; // count
     ss << '0'; // done
     ss << std::hex << std::setw(8) << std::setfill('0') << next;
-    ss << std::hex << std::setw(8) << std::setfill('0') << tid;
+    ss << std::hex << std::setw(8) << std::setfill('0') << tids[0];
   }
 
   send(ss.str());
@@ -1904,8 +2149,13 @@ void Session::Handle_qPlatform_IO_MkDir(ProtocolInterpreter::Handler const &,
     return;
   }
 
-  ErrorCode error =
-      _delegate->onFileCreateDirectory(*this, HexToString(eptr), mode);
+  std::string path;
+  if (!HexToString(eptr, path)) {
+    sendError(kErrorInvalidArgument);
+    return;
+  }
+
+  ErrorCode error = _delegate->onFileCreateDirectory(*this, path, mode);
   //
   // Contrary to normal GDB protocol, we should send
   // just -1 or 0.
@@ -1925,7 +2175,11 @@ void Session::Handle_qPlatform_RunCommand(ProtocolInterpreter::Handler const &,
                                           std::string const &args) {
   size_t comma = args.find(',');
   std::string workingDir;
-  std::string command(HexToString(args.substr(0, comma)));
+  std::string command;
+  if (!HexToString(args.substr(0, comma), command)) {
+    sendError(kErrorInvalidArgument);
+    return;
+  }
 
   char *eptr;
   uint32_t timeout = std::strtoul(&args[comma + 1], &eptr, 16);
@@ -2051,9 +2305,14 @@ void Session::Handle_qSearch(ProtocolInterpreter::Handler const &,
     return;
   }
 
+  //
+  // The pattern is sent as binary data and has already been unescaped.
+  //
+  std::string pattern(args.substr(eptr - args.c_str()));
+
   Address location;
-  ErrorCode error = _delegate->onSearch(
-      *this, address, std::string(HexToString(eptr), length), location);
+  ErrorCode error =
+      _delegate->onSearch(*this, address, length, pattern, location);
   if (error != kSuccess && error != kErrorNotFound) {
     sendError(error);
     return;
@@ -2063,7 +2322,7 @@ void Session::Handle_qSearch(ProtocolInterpreter::Handler const &,
   if (error == kErrorNotFound) {
     ss << '0';
   } else {
-    ss << '1' << ',' << formatAddress(address, kEndianBig);
+    ss << '1' << ',' << formatAddress(location, kEndianBig);
   }
   send(ss.str());
 }
@@ -2142,6 +2401,13 @@ void Session::Handle_qSupported(ProtocolInterpreter::Handler const &,
     }
   });
 
+  //
+  // Clients negotiating features with qSupported know how to expand
+  // run-length encoded replies; this has no effect if the server was told
+  // not to use the encoding.
+  //
+  setRunLengthEncoding(true);
+
   ErrorCode error =
       _delegate->onQuerySupported(*this, remoteFeatures, localFeatures);
   if (error != kSuccess) {
@@ -2214,9 +2480,11 @@ void Session::Handle_qSymbol(ProtocolInterpreter::Handler const &,
 
   std::string name, value;
 
-  value = HexToString(args.substr(0, name_begin));
-  if (++name_begin < args.size()) {
-    name = HexToString(args.substr(name_begin));
+  if (!HexToString(args.substr(0, name_begin), value) ||
+      (++name_begin < args.size() &&
+       !HexToString(args.substr(name_begin), name))) {
+    sendError(kErrorInvalidArgument);
+    return;
   }
 
   std::string next;
@@ -2432,6 +2700,13 @@ void Session::Handle_qXfer(ProtocolInterpreter::Handler const &,
     bool last = true;
     std::string buffer;
 
+    //
+    // Leave room for the 'm' or 'l' prefix.
+    //
+    if (length > packetSize() - 1) {
+      length = packetSize() - 1;
+    }
+
     ErrorCode error = _delegate->onXferRead(*this, object, annex, offset,
                                             length, buffer, last);
     if (error != kSuccess) {
@@ -2519,16 +2794,37 @@ void Session::Handle_qsProcessInfo(ProtocolInterpreter::Handler const &,
   send(info.encode(_compatMode, true));
 }
 
+//
+// Thread lists are sent as comma-separated hexadecimal ids; a thread id
+// takes at most 8 digits, plus the separator, and the reply starts with
+// 'm', so this many ids always fit in a packet.
+//
+static inline size_t ThreadListMaxIds(size_t packetSize) {
+  return std::max<size_t>((packetSize - 1) / 9, 1);
+}
+
+static std::string EncodeThreadList(std::vector<ThreadId> const &tids) {
+  std::ostringstream ss;
+  ss << std::hex;
+  for (size_t n = 0; n < tids.size(); n++) {
+    if (n != 0) {
+      ss << ',';
+    }
+    ss << tids[n];
+  }
+  return ss.str();
+}
+
 //
 // Packet:        qfThreadInfo
-// Description:   Query first thread in the process
+// Description:   Query the first threads in the process.
 // Compatibility: GDB, LLDB
 //
 void Session::Handle_qfThreadInfo(ProtocolInterpreter::Handler const &,
                                   std::string const &) {
-  ThreadId tid;
-  ErrorCode error =
-      _delegate->onQueryThreadList(*this, kAnyProcessId, kAllThreadId, tid);
+  std::vector<ThreadId> tids;
+  ErrorCode error = _delegate->onQueryThreadList(
+      *this, kAnyProcessId, kAllThreadId, ThreadListMaxIds(packetSize()), tids);
   if (error != kSuccess && error != kErrorNotFound) {
     sendError(error);
     return;
@@ -2537,22 +2833,20 @@ void Session::Handle_qfThreadInfo(ProtocolInterpreter::Handler const &,
   if (error == kErrorNotFound) {
     send("l");
   } else {
-    std::ostringstream ss;
-    ss << std::hex << tid;
-    send("m" + ss.str());
+    send("m" + EncodeThreadList(tids));
   }
 }
 
 //
 // Packet:        qsThreadInfo
-// Description:   Query next thread in the process.
+// Description:   Query the next threads in the process.
 // Compatibility: GDB, LLDB
 //
 void Session::Handle_qsThreadInfo(ProtocolInterpreter::Handler const &,
                                   std::string const &) {
-  ThreadId tid;
-  ErrorCode error =
-      _delegate->onQueryThreadList(*this, kAnyProcessId, kAnyThreadId, tid);
+  std::vector<ThreadId> tids;
+  ErrorCode error = _delegate->onQueryThreadList(
+      *this, kAnyProcessId, kAnyThreadId, ThreadListMaxIds(packetSize()), tids);
   if (error != kSuccess && error != kErrorNotFound) {
     sendError(error);
     return;
@@ -2561,9 +2855,7 @@ void Session::Handle_qsThreadInfo(ProtocolInterpreter::Handler const &,
   if (error == kErrorNotFound) {
     send("l");
   } else {
-    std::ostringstream ss;
-    ss << std::hex << tid;
-    send("m" + ss.str());
+    send("m" + EncodeThreadList(tids));
   }
 }
 
@@ -2788,9 +3080,14 @@ void Session::Handle_vAttach(ProtocolInterpreter::Handler const &,
 //
 void Session::Handle_vAttachName(ProtocolInterpreter::Handler const &,
                                  std::string const &args) {
+  std::string name;
+  if (!HexToString(args, name)) {
+    sendError(kErrorInvalidArgument);
+    return;
+  }
+
   StopCode stop;
-  ErrorCode error =
-      _delegate->onAttach(*this, HexToString(args), kAttachNow, stop);
+  ErrorCode error = _delegate->onAttach(*this, name, kAttachNow, stop);
   if (error != kSuccess) {
     sendError(error);
     return;
@@ -2814,9 +3111,14 @@ void Session::Handle_vAttachName(ProtocolInterpreter::Handler const &,
 //
 void Session::Handle_vAttachOrWait(ProtocolInterpreter::Handler const &,
                                    std::string const &args) {
+  std::string name;
+  if (!HexToString(args, name)) {
+    sendError(kErrorInvalidArgument);
+    return;
+  }
+
   StopCode stop;
-  ErrorCode error =
-      _delegate->onAttach(*this, HexToString(args), kAttachOrWait, stop);
+  ErrorCode error = _delegate->onAttach(*this, name, kAttachOrWait, stop);
   if (error != kSuccess) {
     sendError(error);
     return;
@@ -2839,9 +3141,14 @@ void Session::Handle_vAttachOrWait(ProtocolInterpreter::Handler const &,
 //
 void Session::Handle_vAttachWait(ProtocolInterpreter::Handler const &,
                                  std::string const &args) {
+  std::string name;
+  if (!HexToString(args, name)) {
+    sendError(kErrorInvalidArgument);
+    return;
+  }
+
   StopCode stop;
-  ErrorCode error =
-      _delegate->onAttach(*this, HexToString(args), kAttachAndWait, stop);
+  ErrorCode error = _delegate->onAttach(*this, name, kAttachAndWait, stop);
   if (error != kSuccess) {
     sendError(error);
     return;
@@ -2986,10 +3293,14 @@ void Session::Handle_vFile(ProtocolInterpreter::Handler const &,
     }
     uint32_t mode = std::strtoul(eptr, nullptr, 16);
 
+    std::string path;
+    if (!HexToString(args.substr(op_end, comma - op_end), path)) {
+      sendError(kErrorInvalidArgument);
+      return;
+    }
+
     int fd;
-    error = _delegate->onFileOpen(
-        *this, HexToString(args.substr(op_end, comma - op_end)), flags, mode,
-        fd);
+    error = _delegate->onFileOpen(*this, path, flags, mode, fd);
     if (error != kSuccess) {
       ss << 'F' << -1 << ',' << std::hex << error;
     } else {
@@ -3017,12 +3328,23 @@ void Session::Handle_vFile(ProtocolInterpreter::Handler const &,
     }
     uint64_t offset = strtoull(eptr, &eptr, 16);
 
+    //
+    // Leave room for the result and its separator.
+    //
+    if (count > packetSize() - 32) {
+      count = packetSize() - 32;
+    }
+
     std::string buffer;
     ErrorCode error = _delegate->onFileRead(*this, fd, count, offset, buffer);
     if (error != kSuccess) {
       ss << 'F' << -1 << ',' << std::hex << error;
     } else {
-      ss << 'F' << 0 << ';' << Escape(buffer);
+      //
+      // Escaping may grow the data, report a short read of what fits.
+      //
+      buffer.resize(EscapedPrefixLength(buffer, packetSize() - 32));
+      ss << 'F' << std::hex << buffer.size() << ';' << Escape(buffer);
       escaped = true;
     }
   } else if (op == "pwrite") {
@@ -3048,29 +3370,47 @@ void Session::Handle_vFile(ProtocolInterpreter::Handler const &,
       ss << 'F' << 0 << ';' << std::hex << nwritten;
     }
   } else if (op == "unlink") {
-    error = _delegate->onFileRemove(*this, HexToString(&args[op_end]));
+    std::string path;
+    if (!HexToString(&args[op_end], path)) {
+      sendError(kErrorInvalidArgument);
+      return;
+    }
+    error = _delegate->onFileRemove(*this, path);
     if (error != kSuccess) {
       ss << 'F' << -1 << ',' << std::hex << error;
     } else {
       ss << 'F' << 0;
     }
   } else if (op == "readlink") {
+    std::string path;
+    if (!HexToString(&args[op_end], path)) {
+      sendError(kErrorInvalidArgument);
+      return;
+    }
     std::string resolved;
-    error =
-        _delegate->onFileReadLink(*this, HexToString(&args[op_end]), resolved);
+    error = _delegate->onFileReadLink(*this, path, resolved);
     if (error != kSuccess) {
       ss << 'F' << -1 << ',' << std::hex << error;
     } else {
       ss << 'F' << 0 << ';' << StringToHex(resolved);
     }
   } else if (op == "exists") {
-    error = _delegate->onFileExists(*this, HexToString(&args[op_end]));
+    std::string path;
+    if (!HexToString(&args[op_end], path)) {
+      sendError(kErrorInvalidArgument);
+      return;
+    }
+    error = _delegate->onFileExists(*this, path);
     // F,<bool>
     ss << 'F' << ',' << (error != kSuccess ? 0 : 1);
   } else if (op == "MD5") {
+    std::string path;
+    if (!HexToString(&args[op_end], path)) {
+      sendError(kErrorInvalidArgument);
+      return;
+    }
     uint8_t digest[16];
-    error =
-        _delegate->onFileComputeMD5(*this, HexToString(&args[op_end]), digest);
+    error = _delegate->onFileComputeMD5(*this, path, digest);
     ss << 'F' << ',';
     // F,<value> or F,x if not found
     if (error != kSuccess) {
@@ -3081,8 +3421,13 @@ void Session::Handle_vFile(ProtocolInterpreter::Handler const &,
       }
     }
   } else if (op == "size") {
+    std::string path;
+    if (!HexToString(&args[op_end], path)) {
+      sendError(kErrorInvalidArgument);
+      return;
+    }
     uint64_t size;
-    error = _delegate->onFileGetSize(*this, HexToString(&args[op_end]), size);
+    error = _delegate->onFileGetSize(*this, path, size);
     // Fsize or Exx if error.
     ss << 'F' << std::hex << size;
   } else {
@@ -3191,15 +3536,24 @@ void Session::Handle_vRun(ProtocolInterpreter::Handler const &,
   std::string filename;
   StringCollection arguments;
   size_t index = 0;
+  bool valid = true;
 
   ParseList(args, ';', [&](std::string const &arg) {
-    if (index == 0) {
-      filename = HexToString(arg);
+    std::string decoded;
+    if (!HexToString(arg, decoded)) {
+      valid = false;
+    } else if (index == 0) {
+      filename = decoded;
     } else {
-      arguments.push_back(HexToString(arg));
+      arguments.push_back(decoded);
     }
   });
 
+  if (!valid) {
+    sendError(kErrorInvalidArgument);
+    return;
+  }
+
   StopCode stop;
   ErrorCode error = _delegate->onRunAttach(*this, filename, arguments, stop);
   if (error != kSuccess) {
@@ -3305,12 +3659,21 @@ void Session::Handle_x(ProtocolInterpreter::Handler const &,
     return;
   }
 
+  if (length > packetSize()) {
+    length = packetSize();
+  }
+
   ErrorCode error = _delegate->onReadMemory(*this, address, length, data);
   if (error != kSuccess) {
     sendError(error);
     return;
   }
 
+  //
+  // Escaping may grow the data up to twice its size, only send the bytes
+  // that fit; clients handle short reads.
+  //
+  data.resize(EscapedPrefixLength(data, packetSize()));
   send(data);
 }
 
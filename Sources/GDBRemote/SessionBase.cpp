@@ -17,21 +17,26 @@
 #include "DebugServer2/Utils/HexValues.h"
 #include "DebugServer2/Utils/Log.h"
 
-#include <iomanip>
-#include <sstream>
-
 using ds2::Host::Platform;
 
 namespace ds2 {
 namespace GDBRemote {
 
 SessionBase::SessionBase()
-    : _channel(nullptr), _delegate(nullptr), _ackmode(true) {
+    : _channel(nullptr), _delegate(nullptr), _ackmode(true),
+      _runLengthEncoding(false), _runLengthEncodingAllowed(true),
+      _runLengthSavedBytes(0), _packetSize(0) {
   _processor.setDelegate(&_interpreter);
   _interpreter.setSession(this);
 }
 
-SessionBase::~SessionBase() { delete _channel; }
+SessionBase::~SessionBase() {
+  if (_runLengthSavedBytes != 0) {
+    DS2LOG(Remote, Debug, "run-length encoding saved %llu bytes",
+           (unsigned long long)_runLengthSavedBytes);
+  }
+  delete _channel;
+}
 
 bool SessionBase::create(Host::Channel *channel) {
   if (_channel != nullptr || channel == nullptr)
@@ -48,9 +53,15 @@ bool SessionBase::receive(bool cooked) {
   if (!_channel->wait())
     return false;
 
-  std::string data;
+  //
+  // The receive buffer is kept around to avoid allocating on every receive.
+  //
+  std::string &data = _receiveBuffer;
 
-  if (!_channel->receive(data))
+  //
+  // Read a whole packet at once when possible.
+  //
+  if (!_channel->receive(data, packetSize() + 4))
     return false;
 
   if (data.empty())
@@ -77,9 +88,17 @@ bool SessionBase::parse(std::string const &data) {
   return true;
 }
 
+size_t SessionBase::packetSize() const {
+  if (_packetSize != 0)
+    return _packetSize;
+
+  return (mode() == kCompatibilityModeLLDB) ? kLLDBPacketSize
+                                            : kDefaultPacketSize;
+}
+
 bool SessionBase::send(std::string const &data, bool escaped) {
-  std::ostringstream ss;
   std::string encoded;
+  std::string compressed;
   std::string const *datap = &data;
 
   //
@@ -91,12 +110,24 @@ bool SessionBase::send(std::string const &data, bool escaped) {
     datap = &encoded;
   }
 
-  uint8_t csum = Checksum(*datap);
+  //
+  // Run-length encoding is only used with GDB clients.
+  //
+  if (_runLengthEncoding && mode() != kCompatibilityModeLLDB) {
+    compressed = Compress(*datap);
+    _runLengthSavedBytes += datap->length() - compressed.length();
+    datap = &compressed;
+  }
 
-  ss << '$' << *datap << '#' << std::hex << std::setw(2) << std::setfill('0')
-     << (unsigned)csum;
+  uint8_t csum = Checksum(*datap);
 
-  std::string final_data = ss.str();
+  std::string final_data;
+  final_data.reserve(datap->length() + 4);
+  final_data += '$';
+  final_data += *datap;
+  final_data += '#';
+  final_data += NibbleToHex(csum >> 4);
+  final_data += NibbleToHex(csum & 15);
   DS2LOG(Remote, Debug, "putpkt(\"%s\", %u)", final_data.c_str(),
          (unsigned)final_data.length());
 
@@ -160,6 +160,35 @@ std::string ProcessThreadId::encode(CompatibilityMode mode) const {
   return ss.str();
 }
 
+//
+// Stop reasons as understood by LLDB.
+//
+static char const *EncodeReason(StopCode::Reason reason) {
+  switch (reason) {
+  case StopCode::kNone:
+    break;
+  case StopCode::kTrace:
+    return "trace";
+  case StopCode::kBreakpoint:
+    return "breakpoint";
+  case StopCode::kWatchpoint:
+    return "watchpoint";
+  case StopCode::kSignalStop:
+    return "signal";
+  case StopCode::kTrap:
+    return "trap";
+  case StopCode::kException:
+    return "exception";
+  case StopCode::kRegisterWatchpoint:
+  case StopCode::kAddressWatchpoint:
+  case StopCode::kLibraryLoad:
+  case StopCode::kReplayLog:
+    DS2LOG(Protocol, Warning, "stop reason not implemented: %d", reason);
+    break;
+  }
+  return "";
+}
+
 std::string StopCode::encodeInfo(CompatibilityMode mode) const {
   std::ostringstream ss;
 
@@ -203,34 +232,7 @@ std::string StopCode::encodeInfo(CompatibilityMode mode) const {
   //
   if (mode == kCompatibilityModeLLDB) {
     if (reason != kNone) {
-      ss << ';' << "reason:";
-      switch (reason) {
-      case kNone:
-        break;
-      case kTrace:
-        ss << "trace";
-        break;
-      case kBreakpoint:
-        ss << "breakpoint";
-        break;
-      case kWatchpoint:
-        ss << "watchpoint";
-        break;
-      case kSignalStop:
-        ss << "signal";
-        break;
-      case kTrap:
-        ss << "trap";
-        break;
-      case kException:
-        ss << "exception";
-        break;
-      case kRegisterWatchpoint:
-      case kAddressWatchpoint:
-      case kLibraryLoad:
-      case kReplayLog:
-        DS2LOG(Protocol, Warning, "stop reason not implemented: %d", reason);
-      }
+      ss << ';' << "reason:" << EncodeReason(reason);
     }
 
     ss << ';' << "threads:";
@@ -249,6 +251,10 @@ std::string StopCode::encodeInfo(CompatibilityMode mode) const {
         first = false;
       }
     }
+
+    if (!threadsInfo.empty()) {
+      ss << ';' << "jstopinfo:" << StringToHex(threadsInfo);
+    }
   }
 
   return ss.str();
@@ -279,6 +285,72 @@ std::string StopCode::encodeRegisters() const {
   return ss.str();
 }
 
+static void AppendDecimal(std::string &buffer, uint64_t value) {
+  char digits[20];
+  size_t count = 0;
+  do {
+    digits[count++] = '0' + (value % 10);
+    value /= 10;
+  } while (value != 0);
+  while (count > 0) {
+    buffer += digits[--count];
+  }
+}
+
+//
+// Appends the stop information of this thread as a JSON object, as found in
+// the jThreadsInfo reply and in the jstopinfo field of stop replies. The
+// caller owns the buffer so that it can be reused from one stop to the next.
+//
+void StopCode::encodeJSON(std::string &buffer) const {
+  buffer += "{\"tid\":";
+  AppendDecimal(buffer, ptid.tid);
+  if (!threadName.empty()) {
+    buffer += ",\"name\":\"";
+    buffer += EscapeJSON(threadName);
+    buffer += '"';
+  }
+  if (reason != kNone) {
+    buffer += ",\"reason\":\"";
+    buffer += EncodeReason(reason);
+    buffer += "\",\"signal\":";
+    AppendDecimal(buffer, signal & 0xff);
+  }
+  if (!(core < 0)) {
+    buffer += ",\"core\":";
+    AppendDecimal(buffer, core);
+  }
+
+  if (!registers.empty()) {
+    bool first = true;
+
+    //
+    // Register values are sent in target byte order.
+    //
+    buffer += ",\"registers\":{";
+    for (auto &regval : registers) {
+      buffer += first ? "\"" : ",\"";
+      AppendDecimal(buffer, regval.first);
+      buffer += "\":\"";
+      for (size_t n = 0; n < regval.second.size; n++) {
+#ifdef __BIG_ENDIAN__
+        size_t shift = (regval.second.size - n - 1) << 3;
+#else
+        size_t shift = n << 3;
+#endif
+        uint8_t byte = regval.second.value >> shift;
+        buffer += NibbleToHex(byte >> 4);
+        buffer += NibbleToHex(byte & 15);
+      }
+      buffer += '"';
+      first = false;
+    }
+    buffer += '}';
+  }
+
+  buffer += '}';
+}
+
 std::string StopCode::encode(CompatibilityMode mode) const {
   std::ostringstream ss;
   char code;
@@ -620,6 +692,9 @@ std::string MemoryRegionInfo::encode() const {
       ss << 'x';
     ss << ';';
   }
+  if (!name.empty()) {
+    ss << "name:" << StringToHex(name) << ';';
+  }
 
   return ss.str();
 }
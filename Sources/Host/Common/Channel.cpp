@@ -22,22 +22,24 @@ bool Channel::send(std::string const &buffer) {
   return send(&buffer[0], buffer.size()) == static_cast<ssize_t>(buffer.size());
 }
 
-bool Channel::receive(std::string &buffer) {
+bool Channel::receive(std::string &buffer, size_t chunkSize) {
   if (!connected())
     return false;
 
-  buffer.clear();
-
   size_t total = 0;
-  static size_t const chunk = 1024;
   for (;;) {
-    size_t size = buffer.size();
-    buffer.resize(size + chunk);
-    ssize_t nrecvd = receive(&buffer[size], chunk);
-    if (nrecvd == 0)
+    buffer.resize(total + chunkSize);
+    ssize_t nrecvd = receive(&buffer[total], chunkSize);
+    if (nrecvd <= 0)
       break;
 
     total += nrecvd;
+
+    //
+    // A short read means that we drained what was available.
+    //
+    if (static_cast<size_t>(nrecvd) < chunkSize)
+      break;
   }
   buffer.resize(total);
   return !buffer.empty();
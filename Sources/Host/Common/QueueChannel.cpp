@@ -59,7 +59,7 @@ ssize_t QueueChannel::receive(void *buffer, size_t length) {
   return length;
 }
 
-bool QueueChannel::receive(std::string &buffer) {
+bool QueueChannel::receive(std::string &buffer, size_t) {
   if (!connected())
     return false;
 
@@ -66,8 +66,9 @@ void PTrace::initCPUState(ProcessId pid) {
 
 void PTrace::doneCPUState() { delete _privateData; }
 
-ErrorCode PTrace::readCPUState(ProcessThreadId const &ptid, ProcessInfo const &,
-                               Architecture::CPUState &state) {
+ErrorCode PTrace::readCPUState(ProcessThreadId const &ptid,
+                               ProcessArchInfo const &,
+                               Architecture::CPUState &state, uint32_t sets) {
   pid_t pid;
 
   if (!ptid.valid())
@@ -87,23 +88,29 @@ ErrorCode PTrace::readCPUState(ProcessThreadId const &ptid, ProcessInfo const &,
   //
   // Read GPRs
   //
-  struct pt_regs gprs;
-  if (wrapPtrace(PTRACE_GETREGS, pid, nullptr, &gprs) < 0)
-    return TranslateErrno();
+  if (sets & Architecture::kRegisterSetGP) {
+    struct pt_regs gprs;
+    if (wrapPtrace(PTRACE_GETREGS, pid, nullptr, &gprs) < 0)
+      return TranslateErrno();
 
-  //
-  // The layout is identical.
-  //
-  std::memcpy(state.gp.regs, gprs.uregs, sizeof(state.gp.regs));
+    //
+    // The layout is identical.
+    //
+    std::memcpy(state.gp.regs, gprs.uregs, sizeof(state.gp.regs));
+  }
 
 #if (__ARM_ARCH >= 7)
   static_assert(sizeof(state.vfp) == ARM_VFPREGS_SIZE,
                 "sizeof(ARM::CPUState.vfp) does not match ARM_VFPREGS_SIZE");
 
-  if (wrapPtrace(PTRACE_GETVFPREGS, pid, nullptr, &state.vfp) < 0)
+  if ((sets & Architecture::kRegisterSetFP) &&
+      wrapPtrace(PTRACE_GETVFPREGS, pid, nullptr, &state.vfp) < 0)
     return TranslateErrno();
 #endif
 
+  if (!(sets & Architecture::kRegisterSetDebug))
+    return kSuccess;
+
   //
   // Read hardware breakpoints and watchpoints.
   //
@@ -138,8 +145,9 @@ ErrorCode PTrace::readCPUState(ProcessThreadId const &ptid, ProcessInfo const &,
 }
 
 ErrorCode PTrace::writeCPUState(ProcessThreadId const &ptid,
-                                ProcessInfo const &,
-                                Architecture::CPUState const &state) {
+                                ProcessArchInfo const &,
+                                Architecture::CPUState const &state,
+                                uint32_t sets) {
   pid_t pid;
 
   if (!ptid.valid())
@@ -157,38 +165,50 @@ ErrorCode PTrace::writeCPUState(ProcessThreadId const &ptid,
   initCPUState(pid);
 
   //
-  // Read GPRs
+  // Write GPRs
   //
-  struct pt_regs gprs;
+  if (sets & Architecture::kRegisterSetGP) {
+    struct pt_regs gprs;
 
-  //
-  // The layout is identical.
-  //
-  std::memcpy(gprs.uregs, state.gp.regs, sizeof(state.gp.regs));
-  gprs.ARM_ORIG_r0 = 0;
+    //
+    // The layout is identical.
+    //
+    std::memcpy(gprs.uregs, state.gp.regs, sizeof(state.gp.regs));
+    gprs.ARM_ORIG_r0 = 0;
 
-  if (wrapPtrace(PTRACE_SETREGS, pid, nullptr, &gprs) < 0)
-    return TranslateErrno();
+    if (wrapPtrace(PTRACE_SETREGS, pid, nullptr, &gprs) < 0)
+      return TranslateErrno();
+  }
 
 #if (__ARM_ARCH >= 7)
   static_assert(sizeof(state.vfp) == ARM_VFPREGS_SIZE,
                 "sizeof(ARM::CPUState.vfp) does not match ARM_VFPREGS_SIZE");
 
-  if (wrapPtrace(PTRACE_SETVFPREGS, pid, nullptr, &state.vfp) < 0)
+  if ((sets & Architecture::kRegisterSetFP) &&
+      wrapPtrace(PTRACE_SETVFPREGS, pid, nullptr, &state.vfp) < 0)
     return TranslateErrno();
 #endif
 
+  if (!(sets & Architecture::kRegisterSetDebug))
+    return kSuccess;
+
   //
   // Write hardware breakpoints and watchpoints.
   //
   for (size_t n = 0; n < _privateData->breakpointCount; n++) {
-    wrapPtrace(PTRACE_SETHBPREGS, pid, (n << 1) + 1, &state.hbp.bcr[n]);
-    wrapPtrace(PTRACE_GETHBPREGS, pid, (n << 1) + 2, &state.hbp.bvr[n]);
+    if (wrapPtrace(PTRACE_SETHBPREGS, pid, (n << 1) + 1, &state.hbp.bcr[n]) <
+            0 ||
+        wrapPtrace(PTRACE_SETHBPREGS, pid, (n << 1) + 2, &state.hbp.bvr[n]) <
+            0)
+      return TranslateErrno();
   }
 
   for (size_t n = 0; n < _privateData->watchpointCount; n++) {
-    wrapPtrace(PTRACE_SETHBPREGS, pid, -((n << 1) + 1), &state.hbp.wcr[n]);
-    wrapPtrace(PTRACE_SETHBPREGS, pid, -((n << 1) + 2), &state.hbp.wvr[n]);
+    if (wrapPtrace(PTRACE_SETHBPREGS, pid, -((n << 1) + 1),
+                   &state.hbp.wcr[n]) < 0 ||
+        wrapPtrace(PTRACE_SETHBPREGS, pid, -((n << 1) + 2),
+                   &state.hbp.wvr[n]) < 0)
+      return TranslateErrno();
   }
 
   return kSuccess;
@@ -12,22 +12,28 @@
 
 #include "DebugServer2/Host/Linux/PTrace.h"
 #include "DebugServer2/Host/Linux/ExtraWrappers.h"
+#include "DebugServer2/Host/Platform.h"
 #include "DebugServer2/Host/POSIX/AsyncProcessWaiter.h"
 #include "DebugServer2/Utils/Log.h"
 
 #include <cerrno>
 #include <csignal>
 #include <cstdio>
+#include <cstring>
 #include <limits>
 #include <sys/ptrace.h>
+#include <sys/uio.h>
 
 #define super ds2::Host::POSIX::PTrace
 
+using ds2::Host::Platform;
+
 namespace ds2 {
 namespace Host {
 namespace Linux {
 
-PTrace::PTrace() : _privateData(nullptr) {}
+PTrace::PTrace()
+    : _privateData(nullptr), _bulkMemoryAccess(true), _seized(false) {}
 
 PTrace::~PTrace() { doneCPUState(); }
 
@@ -73,18 +79,21 @@ ErrorCode PTrace::traceMe(bool disableASLR) {
   return kSuccess;
 }
 
+//
+// Trace clone and exit events to track threads, and exec events so
+// that per-address-space state can be refreshed.
+//
+unsigned long PTrace::TraceOptions() {
+  return PTRACE_O_TRACECLONE | PTRACE_O_TRACEEXEC;
+}
+
 ErrorCode PTrace::traceThat(ProcessId pid) {
   if (pid <= 0)
     return kErrorInvalidArgument;
 
-  unsigned long traceFlags = PTRACE_O_TRACECLONE;
-
-  //
-  // Trace clone and exit events to track threads.
-  //
-  if (wrapPtrace(PTRACE_SETOPTIONS, pid, nullptr, traceFlags) < 0) {
+  if (wrapPtrace(PTRACE_SETOPTIONS, pid, nullptr, TraceOptions()) < 0) {
     DS2LOG(Main, Warning,
-           "unable to set PTRACE_O_TRACECLONE on pid %d, error=%s", pid,
+           "unable to set ptrace options on pid %d, error=%s", pid,
            strerror(errno));
     return TranslateErrno();
   }
@@ -92,10 +101,29 @@ ErrorCode PTrace::traceThat(ProcessId pid) {
   return kSuccess;
 }
 
+//
+// Attaching seizes the thread, which sets the trace options atomically and
+// lets us stop it with PTRACE_INTERRUPT instead of sending it a SIGSTOP; the
+// thread is then interrupted so that the caller can wait for it as it would
+// after PTRACE_ATTACH. Kernels older than 3.4 don't know about PTRACE_SEIZE,
+// in which case we fall back to PTRACE_ATTACH and SIGSTOP.
+//
 ErrorCode PTrace::attach(ProcessId pid) {
   if (pid <= kAnyProcessId)
     return kErrorProcessNotFound;
 
+  if (wrapPtrace(PTRACE_SEIZE, pid, nullptr, TraceOptions()) == 0) {
+    _seized = true;
+    if (wrapPtrace(PTRACE_INTERRUPT, pid, nullptr, nullptr) < 0)
+      return TranslateErrno();
+    return kSuccess;
+  } else if (errno != EIO && errno != EINVAL) {
+    return TranslateErrno();
+  }
+
+  DS2LOG(Main, Debug, "PTRACE_SEIZE not available, using PTRACE_ATTACH");
+  _seized = false;
+
   if (wrapPtrace(PTRACE_ATTACH, pid, nullptr, nullptr) < 0)
     return TranslateErrno();
 
@@ -135,6 +163,173 @@ ErrorCode PTrace::kill(ProcessThreadId const &ptid, int signal) {
   return kSuccess;
 }
 
+//
+// Maximum number of remote iovecs passed to a single process_vm_readv or
+// process_vm_writev call. Each iovec covers at most one page so that the
+// kernel reports partial transfers at page granularity.
+//
+static size_t const kMaxBulkIOVecs = 64;
+
+static size_t PrepareBulkIOVecs(uint64_t address, size_t length,
+                                struct iovec *iovs) {
+  size_t pageSize = Platform::GetPageSize();
+  size_t niovs = 0;
+
+  while (length > 0 && niovs < kMaxBulkIOVecs) {
+    size_t ncopy = std::min(length, pageSize - (address & (pageSize - 1)));
+    iovs[niovs].iov_base = reinterpret_cast<void *>(address);
+    iovs[niovs].iov_len = ncopy;
+    address += ncopy, length -= ncopy, niovs++;
+  }
+
+  return niovs;
+}
+
+ErrorCode PTrace::readMemoryBulk(ProcessId pid, uint64_t address,
+                                 void *buffer, size_t length, size_t &nread) {
+  nread = 0;
+
+  if (!_bulkMemoryAccess)
+    return kErrorUnsupported;
+
+  while (nread < length) {
+    struct iovec local, remote[kMaxBulkIOVecs];
+    size_t niovs =
+        PrepareBulkIOVecs(address + nread, length - nread, remote);
+
+    local.iov_base = static_cast<uint8_t *>(buffer) + nread;
+    local.iov_len = 0;
+    for (size_t n = 0; n < niovs; n++) {
+      local.iov_len += remote[n].iov_len;
+    }
+
+    ssize_t ret = ::process_vm_readv(pid, &local, 1, remote, niovs, 0);
+    if (ret < 0) {
+      if (errno == ENOSYS) {
+        DS2LOG(Main, Debug, "process_vm_readv not available, using ptrace");
+        _bulkMemoryAccess = false;
+      }
+      return (errno == ENOSYS || errno == EPERM) ? kErrorUnsupported
+                                                 : TranslateErrno();
+    }
+
+    nread += ret;
+
+    //
+    // A short transfer means that we hit an unmapped or unreadable page.
+    //
+    if (static_cast<size_t>(ret) < local.iov_len)
+      break;
+  }
+
+  return kSuccess;
+}
+
+ErrorCode PTrace::writeMemoryBulk(ProcessId pid, uint64_t address,
+                                  void const *buffer, size_t length,
+                                  size_t &nwritten) {
+  nwritten = 0;
+
+  if (!_bulkMemoryAccess)
+    return kErrorUnsupported;
+
+  while (nwritten < length) {
+    struct iovec local, remote[kMaxBulkIOVecs];
+    size_t niovs =
+        PrepareBulkIOVecs(address + nwritten, length - nwritten, remote);
+
+    local.iov_base =
+        const_cast<uint8_t *>(static_cast<uint8_t const *>(buffer)) + nwritten;
+    local.iov_len = 0;
+    for (size_t n = 0; n < niovs; n++) {
+      local.iov_len += remote[n].iov_len;
+    }
+
+    ssize_t ret = ::process_vm_writev(pid, &local, 1, remote, niovs, 0);
+    if (ret < 0) {
+      if (errno == ENOSYS) {
+        DS2LOG(Main, Debug, "process_vm_writev not available, using ptrace");
+        _bulkMemoryAccess = false;
+      }
+      return (errno == ENOSYS || errno == EPERM) ? kErrorUnsupported
+                                                 : TranslateErrno();
+    }
+
+    nwritten += ret;
+
+    //
+    // A short transfer means that we hit an unmapped or read-only page,
+    // e.g. program text.
+    //
+    if (static_cast<size_t>(ret) < local.iov_len)
+      break;
+  }
+
+  return kSuccess;
+}
+
+ErrorCode PTrace::readMemoryWords(ProcessId pid, uint64_t address,
+                                  void *buffer, size_t length, size_t &nread) {
+  uint8_t *bytes = static_cast<uint8_t *>(buffer);
+
+  nread = 0;
+  while (nread < length) {
+    union {
+      uintptr_t word;
+      uint8_t bytes[sizeof(uintptr_t)];
+    } data;
+    size_t ncopy = std::min(length - nread, sizeof(uintptr_t));
+
+    errno = 0;
+    data.word = wrapPtrace(PTRACE_PEEKDATA, pid, address + nread, nullptr);
+    if (errno != 0)
+      return TranslateErrno();
+
+    std::memcpy(bytes + nread, data.bytes, ncopy);
+    nread += ncopy;
+  }
+
+  return kSuccess;
+}
+
+ErrorCode PTrace::writeMemoryWords(ProcessId pid, uint64_t address,
+                                   void const *buffer, size_t length,
+                                   size_t &nwritten) {
+  uint8_t const *bytes = static_cast<uint8_t const *>(buffer);
+
+  nwritten = 0;
+  while (nwritten < length) {
+    union {
+      uintptr_t word;
+      uint8_t bytes[sizeof(uintptr_t)];
+    } data;
+    size_t ncopy = std::min(length - nwritten, sizeof(uintptr_t));
+
+    errno = 0;
+    if (ncopy < sizeof(uintptr_t)) {
+      data.word = wrapPtrace(PTRACE_PEEKDATA, pid, address + nwritten, nullptr);
+      if (errno != 0)
+        return TranslateErrno();
+    }
+
+    std::memcpy(data.bytes, bytes + nwritten, ncopy);
+    if (wrapPtrace(PTRACE_POKEDATA, pid, address + nwritten, data.word) < 0)
+      return TranslateErrno();
+
+    nwritten += ncopy;
+  }
+
+  return kSuccess;
+}
+
+//
+// Memory is transferred with process_vm_readv/process_vm_writev when the
+// kernel supports it; whatever the bulk path could not transfer (e.g. a
+// page that is not readable or writable from the outside, like program
+// text) is retried word by word with PTRACE_PEEKDATA/PTRACE_POKEDATA.
+// When only a prefix of the range can be transferred, that prefix is
+// returned if the caller asked for the transferred count.
+//
 ErrorCode PTrace::readMemory(ProcessThreadId const &ptid,
                              Address const &address, void *buffer,
                              size_t length, size_t *count) {
@@ -149,10 +344,6 @@ ErrorCode PTrace::readMemory(ProcessThreadId const &ptid,
     pid = ptid.pid;
   }
 
-  size_t nread = 0;
-  uintptr_t base = address;
-  uintptr_t *words = (uintptr_t *)buffer;
-
   if (length == 0 || buffer == nullptr) {
     if (count != nullptr) {
       *count = 0;
@@ -160,31 +351,23 @@ ErrorCode PTrace::readMemory(ProcessThreadId const &ptid,
     return kSuccess;
   }
 
-  while (length > 0) {
-    union {
-      uintptr_t word;
-      uint8_t bytes[sizeof(uintptr_t)];
-    } data;
-    size_t ncopy = std::min(length, sizeof(uintptr_t));
-
-    errno = 0;
-    if (ncopy < sizeof(uintptr_t)) {
-      data.word = wrapPtrace(PTRACE_PEEKDATA, pid, base + nread, nullptr);
-      if (errno == 0) {
-        std::memcpy(words, data.bytes, ncopy);
-      }
-    } else {
-      *words = wrapPtrace(PTRACE_PEEKDATA, pid, base + nread, nullptr);
-    }
-
-    if (errno != 0)
-      break;
-
-    length -= ncopy, nread += ncopy, words++;
+  size_t nbulk = 0, nwords = 0;
+  ErrorCode error = readMemoryBulk(pid, address, buffer, length, nbulk);
+  if (nbulk < length) {
+    error = readMemoryWords(pid, address + nbulk,
+                            static_cast<uint8_t *>(buffer) + nbulk,
+                            length - nbulk, nwords);
   }
 
-  if (errno != 0)
-    return TranslateErrno();
+  DS2LOG(Main, Debug,
+         "read %zu/%zu bytes at %#llx from pid %d (process_vm_readv=%zu, "
+         "PTRACE_PEEKDATA=%zu)",
+         nbulk + nwords, length, (unsigned long long)address.value(), pid,
+         nbulk, nwords);
+
+  size_t nread = nbulk + nwords;
+  if (nread < length && (nread == 0 || count == nullptr))
+    return error;
 
   if (count != nullptr) {
     *count = nread;
@@ -207,10 +390,6 @@ ErrorCode PTrace::writeMemory(ProcessThreadId const &ptid,
     pid = ptid.pid;
   }
 
-  size_t nwritten = 0;
-  uintptr_t base = address;
-  uintptr_t const *words = (uintptr_t const *)buffer;
-
   if (length == 0 || buffer == nullptr) {
     if (count != nullptr) {
       *count = 0;
@@ -218,32 +397,23 @@ ErrorCode PTrace::writeMemory(ProcessThreadId const &ptid,
     return kSuccess;
   }
 
-  while (length > 0) {
-    union {
-      uintptr_t word;
-      uint8_t bytes[sizeof(uintptr_t)];
-    } data;
-    size_t ncopy = std::min(length, sizeof(uintptr_t));
-
-    errno = 0;
-    if (ncopy < sizeof(uintptr_t)) {
-      data.word = wrapPtrace(PTRACE_PEEKDATA, pid, base + nwritten, nullptr);
-      if (errno == 0) {
-        std::memcpy(data.bytes, words, ncopy);
-        wrapPtrace(PTRACE_POKEDATA, pid, base + nwritten, data.word);
-      }
-    } else {
-      wrapPtrace(PTRACE_POKEDATA, pid, base + nwritten, *words);
-    }
-
-    if (errno != 0)
-      break;
-
-    length -= ncopy, nwritten += ncopy, words++;
+  size_t nbulk = 0, nwords = 0;
+  ErrorCode error = writeMemoryBulk(pid, address, buffer, length, nbulk);
+  if (nbulk < length) {
+    error = writeMemoryWords(pid, address + nbulk,
+                             static_cast<uint8_t const *>(buffer) + nbulk,
+                             length - nbulk, nwords);
   }
 
-  if (errno != 0)
-    return TranslateErrno();
+  DS2LOG(Main, Debug,
+         "wrote %zu/%zu bytes at %#llx to pid %d (process_vm_writev=%zu, "
+         "PTRACE_POKEDATA=%zu)",
+         nbulk + nwords, length, (unsigned long long)address.value(), pid,
+         nbulk, nwords);
+
+  size_t nwritten = nbulk + nwords;
+  if (nwritten < length && (nwritten == 0 || count == nullptr))
+    return error;
 
   if (count != nullptr) {
     *count = nwritten;
@@ -264,14 +434,38 @@ ErrorCode PTrace::suspend(ProcessThreadId const &ptid) {
     pid = ptid.pid;
   }
 
-  if (tkill(pid, SIGSTOP) < 0)
+  if (_seized) {
+    if (wrapPtrace(PTRACE_INTERRUPT, pid, nullptr, nullptr) < 0)
+      return TranslateErrno();
+  } else {
+    if (tkill(pid, SIGSTOP) < 0)
+      return TranslateErrno();
+  }
+
+  return kSuccess;
+}
+
+ErrorCode PTrace::listen(ProcessThreadId const &ptid) {
+  pid_t pid;
+
+  if (!ptid.valid() || !_seized)
+    return kErrorInvalidArgument;
+
+  if (!(ptid.tid <= kAnyThreadId)) {
+    pid = ptid.tid;
+  } else {
+    pid = ptid.pid;
+  }
+
+  if (wrapPtrace(PTRACE_LISTEN, pid, nullptr, nullptr) < 0)
     return TranslateErrno();
 
   return kSuccess;
 }
 
-ErrorCode PTrace::step(ProcessThreadId const &ptid, ProcessInfo const &pinfo,
-                       int signal, Address const &address) {
+ErrorCode PTrace::step(ProcessThreadId const &ptid,
+                       ProcessArchInfo const &pinfo, int signal,
+                       Address const &address) {
   pid_t pid;
 
   if (!ptid.valid())
@@ -295,13 +489,14 @@ ErrorCode PTrace::step(ProcessThreadId const &ptid, ProcessInfo const &pinfo,
   //
   if (address.valid()) {
     Architecture::CPUState state;
-    ErrorCode error = readCPUState(ptid, pinfo, state);
+    ErrorCode error =
+        readCPUState(ptid, pinfo, state, Architecture::kRegisterSetGP);
     if (error != kSuccess)
       return error;
 
     state.setPC(address);
 
-    error = writeCPUState(ptid, pinfo, state);
+    error = writeCPUState(ptid, pinfo, state, Architecture::kRegisterSetGP);
     if (error != kSuccess)
       return error;
   }
@@ -312,8 +507,9 @@ ErrorCode PTrace::step(ProcessThreadId const &ptid, ProcessInfo const &pinfo,
   return kSuccess;
 }
 
-ErrorCode PTrace::resume(ProcessThreadId const &ptid, ProcessInfo const &pinfo,
-                         int signal, Address const &address) {
+ErrorCode PTrace::resume(ProcessThreadId const &ptid,
+                         ProcessArchInfo const &pinfo, int signal,
+                         Address const &address) {
   pid_t pid;
 
   if (!ptid.valid())
@@ -330,13 +526,14 @@ ErrorCode PTrace::resume(ProcessThreadId const &ptid, ProcessInfo const &pinfo,
   //
   if (address.valid()) {
     Architecture::CPUState state;
-    ErrorCode error = readCPUState(ptid, pinfo, state);
+    ErrorCode error =
+        readCPUState(ptid, pinfo, state, Architecture::kRegisterSetGP);
     if (error != kSuccess)
       return error;
 
     state.setPC(address);
 
-    error = writeCPUState(ptid, pinfo, state);
+    error = writeCPUState(ptid, pinfo, state, Architecture::kRegisterSetGP);
     if (error != kSuccess)
       return error;
   }
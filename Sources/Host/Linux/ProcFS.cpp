@@ -834,19 +834,141 @@ bool ProcFS::EnumerateProcesses(bool allUsers, uid_t uid,
   return true;
 }
 
+//
+// Layout of the records returned by getdents64(2).
+//
+struct linux_dirent64 {
+  uint64_t d_ino;
+  int64_t d_off;
+  unsigned short d_reclen;
+  unsigned char d_type;
+  char d_name[1];
+};
+
+//
+// Processes can have thousands of threads, so the task directory is read
+// with getdents64(2) directly, one large batch of entries per system call,
+// without going through the DIR stream buffering.
+//
 bool ProcFS::EnumerateThreads(pid_t pid, std::function<void(pid_t)> const &cb) {
-  DIR *dir = OpenDIR(pid, "task");
-  if (dir == nullptr)
+  int fd = OpenFd(pid, "task", O_RDONLY | O_DIRECTORY);
+  if (fd < 0)
     return false;
 
-  while (struct dirent *dp = readdir(dir)) {
-    pid_t pid = strtol(dp->d_name, nullptr, 0);
-    if (pid == 0)
+  static size_t const kBufferSize = 32 * 1024;
+  union {
+    uint64_t align;
+    char data[kBufferSize];
+  } buffer;
+
+  for (;;) {
+    ssize_t nread = getdents64(fd, buffer.data, sizeof(buffer.data));
+    if (nread <= 0)
+      break;
+
+    for (ssize_t offset = 0; offset < nread;) {
+      struct linux_dirent64 const *dp =
+          reinterpret_cast<struct linux_dirent64 const *>(buffer.data +
+                                                          offset);
+      offset += dp->d_reclen;
+
+      pid_t tid = strtol(dp->d_name, nullptr, 10);
+      if (tid <= 0)
+        continue;
+
+      cb(tid);
+    }
+  }
+  close(fd);
+
+  return true;
+}
+
+//
+// Lines of /proc/<pid>/maps have the following format, where the path is
+// optional and may contain spaces:
+//   start-end perms offset major:minor inode path
+//
+static bool ParseMapsLine(char const *line, char const *eol,
+                          MemoryRegionInfo &region) {
+  char *eptr;
+
+  uint64_t start = std::strtoull(line, &eptr, 16);
+  if (*eptr++ != '-')
+    return false;
+  uint64_t end = std::strtoull(eptr, &eptr, 16);
+  if (*eptr++ != ' ' || eol - eptr < 4)
+    return false;
+
+  region.start = start;
+  region.length = end - start;
+  if (eptr[0] == 'r')
+    region.protection |= kProtectionRead;
+  if (eptr[1] == 'w')
+    region.protection |= kProtectionWrite;
+  if (eptr[2] == 'x')
+    region.protection |= kProtectionExecute;
+
+  region.offset = std::strtoull(eptr + 4, &eptr, 16);
+
+  // Skip the device numbers.
+  while (*eptr == ' ' && eptr < eol)
+    eptr++;
+  while (*eptr != ' ' && eptr < eol)
+    eptr++;
+  region.inode = std::strtoull(eptr, &eptr, 10);
+
+  while (*eptr == ' ' && eptr < eol)
+    eptr++;
+  region.name.assign(eptr, eol - eptr);
+
+  return true;
+}
+
+bool ProcFS::EnumerateMemoryRegions(
+    pid_t pid, std::function<void(MemoryRegionInfo const &)> const &cb) {
+  int fd = OpenFd(pid, "maps");
+  if (fd < 0)
+    return false;
+
+  //
+  // Read the whole file at once instead of line by line; it can be large
+  // for processes with many mappings.
+  //
+  std::string contents;
+  for (;;) {
+    static size_t const chunkSize = 64 * 1024;
+    size_t size = contents.size();
+    contents.resize(size + chunkSize);
+
+    ssize_t nread = ::read(fd, &contents[size], chunkSize);
+    if (nread < 0 && errno == EINTR) {
+      contents.resize(size);
       continue;
+    }
+    if (nread <= 0) {
+      contents.resize(size);
+      break;
+    }
 
-    cb(pid);
+    contents.resize(size + nread);
+  }
+  ::close(fd);
+
+  char const *line = contents.c_str();
+  while (*line != '\0') {
+    char const *eol = std::strchr(line, '\n');
+    if (eol == nullptr) {
+      eol = line + std::strlen(line);
+    }
+
+    MemoryRegionInfo region;
+    if (ParseMapsLine(line, eol, region)) {
+      cb(region);
+    }
+
+    line = (*eol == '\n') ? eol + 1 : eol;
   }
-  closedir(dir);
 
   return true;
 }
@@ -40,8 +40,9 @@ void PTrace::initCPUState(ProcessId pid) {
 
 void PTrace::doneCPUState() { delete _privateData; }
 
-ErrorCode PTrace::readCPUState(ProcessThreadId const &ptid, ProcessInfo const &,
-                               Architecture::CPUState &state) {
+ErrorCode PTrace::readCPUState(ProcessThreadId const &ptid,
+                               ProcessArchInfo const &,
+                               Architecture::CPUState &state, uint32_t sets) {
   pid_t pid;
 
   if (!ptid.valid())
@@ -61,27 +62,32 @@ ErrorCode PTrace::readCPUState(ProcessThreadId const &ptid, ProcessInfo const &,
   //
   // Read GPRs
   //
-  user_regs_struct gprs;
-  if (wrapPtrace(PTRACE_GETREGS, pid, nullptr, &gprs) < 0)
-    return TranslateErrno();
-
-  state.gp.eax = gprs.eax;
-  state.gp.ecx = gprs.ecx;
-  state.gp.edx = gprs.edx;
-  state.gp.ebx = gprs.ebx;
-  state.gp.esi = gprs.esi;
-  state.gp.edi = gprs.edi;
-  state.gp.ebp = gprs.ebp;
-  state.gp.esp = gprs.esp;
-  state.gp.eip = gprs.eip;
-  state.gp.cs = gprs.xcs & 0xffff;
-  state.gp.ss = gprs.xss & 0xffff;
-  state.gp.ds = gprs.xds & 0xffff;
-  state.gp.es = gprs.xes & 0xffff;
-  state.gp.fs = gprs.xfs & 0xffff;
-  state.gp.gs = gprs.xgs & 0xffff;
-  state.gp.eflags = gprs.eflags;
-  state.linux_gp.orig_eax = gprs.orig_eax;
+  if (sets & Architecture::kRegisterSetGP) {
+    user_regs_struct gprs;
+    if (wrapPtrace(PTRACE_GETREGS, pid, nullptr, &gprs) < 0)
+      return TranslateErrno();
+
+    state.gp.eax = gprs.eax;
+    state.gp.ecx = gprs.ecx;
+    state.gp.edx = gprs.edx;
+    state.gp.ebx = gprs.ebx;
+    state.gp.esi = gprs.esi;
+    state.gp.edi = gprs.edi;
+    state.gp.ebp = gprs.ebp;
+    state.gp.esp = gprs.esp;
+    state.gp.eip = gprs.eip;
+    state.gp.cs = gprs.xcs & 0xffff;
+    state.gp.ss = gprs.xss & 0xffff;
+    state.gp.ds = gprs.xds & 0xffff;
+    state.gp.es = gprs.xes & 0xffff;
+    state.gp.fs = gprs.xfs & 0xffff;
+    state.gp.gs = gprs.xgs & 0xffff;
+    state.gp.eflags = gprs.eflags;
+    state.linux_gp.orig_eax = gprs.orig_eax;
+  }
+
+  if (!(sets & Architecture::kRegisterSetFP))
+    return kSuccess;
 
   //
   // Read X87 and SSE state
@@ -117,21 +123,21 @@ ErrorCode PTrace::readCPUState(ProcessThreadId const &ptid, ProcessInfo const &,
     // Try reading only X87
     //
     user_fpregs_struct fprs;
-    if (wrapPtrace(PTRACE_GETFPREGS, pid, nullptr, &fprs) == 0) {
-      state.x87.fstw = fprs.swd;
-      state.x87.fctw = fprs.cwd;
-      state.x87.ftag = fprs.twd;
-      state.x87.fiseg = fprs.fcs;
-      state.x87.fioff = fprs.fip;
-      state.x87.foseg = fprs.fos;
-      state.x87.fooff = fprs.foo;
-
-      uint8_t const *st_space =
-          reinterpret_cast<uint8_t const *>(fprs.st_space);
-      for (size_t n = 0; n < 8; n++) {
-        memcpy(state.x87.regs[n].bytes, st_space + n * 10,
-               sizeof(state.x87.regs[n].bytes));
-      }
+    if (wrapPtrace(PTRACE_GETFPREGS, pid, nullptr, &fprs) < 0)
+      return TranslateErrno();
+
+    state.x87.fstw = fprs.swd;
+    state.x87.fctw = fprs.cwd;
+    state.x87.ftag = fprs.twd;
+    state.x87.fiseg = fprs.fcs;
+    state.x87.fioff = fprs.fip;
+    state.x87.foseg = fprs.fos;
+    state.x87.fooff = fprs.foo;
+
+    uint8_t const *st_space = reinterpret_cast<uint8_t const *>(fprs.st_space);
+    for (size_t n = 0; n < 8; n++) {
+      memcpy(state.x87.regs[n].bytes, st_space + n * 10,
+             sizeof(state.x87.regs[n].bytes));
     }
   }
 
@@ -139,8 +145,9 @@ ErrorCode PTrace::readCPUState(ProcessThreadId const &ptid, ProcessInfo const &,
 }
 
 ErrorCode PTrace::writeCPUState(ProcessThreadId const &ptid,
-                                ProcessInfo const &,
-                                Architecture::CPUState const &state) {
+                                ProcessArchInfo const &,
+                                Architecture::CPUState const &state,
+                                uint32_t sets) {
   pid_t pid;
 
   if (!ptid.valid())
@@ -158,30 +165,35 @@ ErrorCode PTrace::writeCPUState(ProcessThreadId const &ptid,
   initCPUState(pid);
 
   //
-  // Read GPRs
+  // Write GPRs
   //
-  user_regs_struct gprs;
-  std::memset(&gprs, 0, sizeof(gprs));
-  gprs.eax = state.gp.eax;
-  gprs.ecx = state.gp.ecx;
-  gprs.edx = state.gp.edx;
-  gprs.ebx = state.gp.ebx;
-  gprs.esi = state.gp.esi;
-  gprs.edi = state.gp.edi;
-  gprs.ebp = state.gp.ebp;
-  gprs.esp = state.gp.esp;
-  gprs.eip = state.gp.eip;
-  gprs.xcs = state.gp.cs & 0xffff;
-  gprs.xss = state.gp.ss & 0xffff;
-  gprs.xds = state.gp.ds & 0xffff;
-  gprs.xes = state.gp.es & 0xffff;
-  gprs.xfs = state.gp.fs & 0xffff;
-  gprs.xgs = state.gp.gs & 0xffff;
-  gprs.eflags = state.gp.eflags;
-  gprs.orig_eax = state.linux_gp.orig_eax;
-
-  if (wrapPtrace(PTRACE_SETREGS, pid, nullptr, &gprs) < 0)
-    return TranslateErrno();
+  if (sets & Architecture::kRegisterSetGP) {
+    user_regs_struct gprs;
+    std::memset(&gprs, 0, sizeof(gprs));
+    gprs.eax = state.gp.eax;
+    gprs.ecx = state.gp.ecx;
+    gprs.edx = state.gp.edx;
+    gprs.ebx = state.gp.ebx;
+    gprs.esi = state.gp.esi;
+    gprs.edi = state.gp.edi;
+    gprs.ebp = state.gp.ebp;
+    gprs.esp = state.gp.esp;
+    gprs.eip = state.gp.eip;
+    gprs.xcs = state.gp.cs & 0xffff;
+    gprs.xss = state.gp.ss & 0xffff;
+    gprs.xds = state.gp.ds & 0xffff;
+    gprs.xes = state.gp.es & 0xffff;
+    gprs.xfs = state.gp.fs & 0xffff;
+    gprs.xgs = state.gp.gs & 0xffff;
+    gprs.eflags = state.gp.eflags;
+    gprs.orig_eax = state.linux_gp.orig_eax;
+
+    if (wrapPtrace(PTRACE_SETREGS, pid, nullptr, &gprs) < 0)
+      return TranslateErrno();
+  }
+
+  if (!(sets & Architecture::kRegisterSetFP))
+    return kSuccess;
 
   //
   // Write X87 and SSE state
@@ -230,7 +242,8 @@ ErrorCode PTrace::writeCPUState(ProcessThreadId const &ptid,
       memcpy(st_space + n * 10, state.x87.regs[n].bytes,
              sizeof(state.x87.regs[n].bytes));
     }
-    wrapPtrace(PTRACE_SETFPREGS, pid, nullptr, &fprs);
+    if (wrapPtrace(PTRACE_SETFPREGS, pid, nullptr, &fprs) < 0)
+      return TranslateErrno();
   }
 
   return kSuccess;
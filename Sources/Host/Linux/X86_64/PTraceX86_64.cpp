@@ -10,11 +10,14 @@
 
 #include "DebugServer2/Host/Linux/PTrace.h"
 #include "DebugServer2/Host/Linux/ExtraWrappers.h"
+#include "DebugServer2/Utils/Log.h"
 
+#include <cpuid.h>
 #include <sys/ptrace.h>
 #include <sys/uio.h>
 #include <sys/user.h>
 #include <elf.h>
+#include <vector>
 
 #define super ds2::Host::POSIX::PTrace
 
@@ -22,17 +25,70 @@
 #define mxcr_mask mxcsr_mask
 #endif
 
+#if !defined(NT_X86_XSTATE)
+#define NT_X86_XSTATE 0x202
+#endif
+
 namespace ds2 {
 namespace Host {
 namespace Linux {
 
+//
+// XSAVE area layout (standard format, as used by NT_X86_XSTATE).
+//
+enum {
+  kXSaveXCR0Offset = 464,  // In the software reserved bytes of FXSAVE
+  kXSaveHeaderOffset = 512 // XSTATE_BV is the first quad of the header
+};
+
+enum {
+  kXStateSSE = 1,
+  kXStateAVX = 2,
+  kXStateOpmask = 5,
+  kXStateZMMHi256 = 6,
+  kXStateHi16ZMM = 7,
+  kXStateCount = 8
+};
+
 struct PTracePrivateData {
   uint8_t breakpointCount;
   uint8_t watchpointCount;
   uint8_t maxWatchpointSize;
 
+  //
+  // Reusable buffer for PTRACE_{GET,SET}REGSET(NT_X86_XSTATE) transfers,
+  // sized from CPUID; empty when XSAVE is unavailable and we have to fall
+  // back to PTRACE_{GET,SET}FPREGS.
+  //
+  std::vector<uint8_t> xsave;
+  uint32_t xstateOffsets[kXStateCount];
+
   PTracePrivateData()
-      : breakpointCount(0), watchpointCount(0), maxWatchpointSize(0) {}
+      : breakpointCount(0), watchpointCount(0), maxWatchpointSize(0) {
+    unsigned int eax, ebx, ecx, edx;
+
+    memset(xstateOffsets, 0, sizeof(xstateOffsets));
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_OSXSAVE))
+      return;
+
+    //
+    // Leaf 0xd, sub-leaf 0: ECX holds the size of the XSAVE area for all
+    // the components supported by the processor; sub-leaves 2+ hold the
+    // offset of each component in EBX.
+    //
+    __cpuid_count(0xd, 0, eax, ebx, ecx, edx);
+    size_t size = ecx;
+    if (size <= kXSaveHeaderOffset)
+      return;
+
+    for (unsigned int n = kXStateAVX; n < kXStateCount; n++) {
+      __cpuid_count(0xd, n, eax, ebx, ecx, edx);
+      xstateOffsets[n] = ebx;
+    }
+
+    xsave.resize(size);
+  }
 };
 
 void PTrace::initCPUState(ProcessId pid) {
@@ -279,9 +335,142 @@ state64_to_user(user_fpregs_struct &user,
   }
 }
 
+//
+// XSAVE helpers
+//
+
+static inline uint64_t xsave_quad(uint8_t const *xsave, size_t offset) {
+  uint64_t value;
+  memcpy(&value, xsave + offset, sizeof(value));
+  return value;
+}
+
+//
+// Copies the index-th element of an XSAVE component, or clears it when the
+// component is in its initial state (its XSTATE_BV bit is clear) or isn't
+// part of the area the kernel gave us.
+//
+static inline void xsave_get(PTracePrivateData const &pd, uint8_t const *xsave,
+                             size_t size, unsigned int component, size_t index,
+                             void *dest, size_t length) {
+  uint64_t xstate_bv = xsave_quad(xsave, kXSaveHeaderOffset);
+  size_t offset = pd.xstateOffsets[component] + index * length;
+
+  if ((xstate_bv & (1ULL << component)) && pd.xstateOffsets[component] != 0 &&
+      offset + length <= size) {
+    memcpy(dest, xsave + offset, length);
+  } else {
+    memset(dest, 0, length);
+  }
+}
+
+static inline void xsave_set(PTracePrivateData const &pd, uint8_t *xsave,
+                             size_t size, unsigned int component, size_t index,
+                             void const *src, size_t length) {
+  uint64_t xcr0 = xsave_quad(xsave, kXSaveXCR0Offset);
+  size_t offset = pd.xstateOffsets[component] + index * length;
+
+  if (!(xcr0 & (1ULL << component)) || pd.xstateOffsets[component] == 0 ||
+      offset + length > size)
+    return;
+
+  memcpy(xsave + offset, src, length);
+
+  uint64_t xstate_bv = xsave_quad(xsave, kXSaveHeaderOffset);
+  xstate_bv |= (1ULL << component);
+  memcpy(xsave + kXSaveHeaderOffset, &xstate_bv, sizeof(xstate_bv));
+}
+
+//
+// The legacy region of the XSAVE area is laid out as FXSAVE, the same as
+// user_fpregs_struct. Since we always rewrite it fully, mark the x87 and SSE
+// components as modified so that the kernel doesn't reset them.
+//
+static inline void xsave_set_legacy(uint8_t *xsave,
+                                    user_fpregs_struct const &fprs) {
+  memcpy(xsave, &fprs, sizeof(fprs));
+
+  uint64_t xstate_bv = xsave_quad(xsave, kXSaveHeaderOffset);
+  xstate_bv |= (1ULL << 0) | (1ULL << kXStateSSE);
+  memcpy(xsave + kXSaveHeaderOffset, &xstate_bv, sizeof(xstate_bv));
+}
+
+static inline void
+xsave_to_state32(ds2::Architecture::X86_64::CPUState32 &state,
+                 PTracePrivateData const &pd, uint8_t const *xsave,
+                 size_t size) {
+  user_to_state32(state, *reinterpret_cast<user_fpregs_struct const *>(xsave));
+
+  for (size_t n = 0; n < 8; n++) {
+    uint8_t *ymm = reinterpret_cast<uint8_t *>(&state.avx.regs[n]);
+    xsave_get(pd, xsave, size, kXStateAVX, n, ymm + 16, 16);
+  }
+}
+
+static inline void
+state32_to_xsave(uint8_t *xsave, size_t size, PTracePrivateData const &pd,
+                 ds2::Architecture::X86_64::CPUState32 const &state) {
+  user_fpregs_struct fprs;
+  memcpy(&fprs, xsave, sizeof(fprs));
+  state32_to_user(fprs, state);
+  xsave_set_legacy(xsave, fprs);
+
+  for (size_t n = 0; n < 8; n++) {
+    uint8_t const *ymm = reinterpret_cast<uint8_t const *>(&state.avx.regs[n]);
+    xsave_set(pd, xsave, size, kXStateAVX, n, ymm + 16, 16);
+  }
+}
+
+static inline void
+xsave_to_state64(ds2::Architecture::X86_64::CPUState64 &state,
+                 PTracePrivateData const &pd, uint8_t const *xsave,
+                 size_t size) {
+  user_to_state64(state, *reinterpret_cast<user_fpregs_struct const *>(xsave));
+  state.xcr0 = xsave_quad(xsave, kXSaveXCR0Offset);
+
+  for (size_t n = 0; n < 32; n++) {
+    uint8_t *zmm = reinterpret_cast<uint8_t *>(&state.eavx.regs[n]);
+    if (n < 16) {
+      xsave_get(pd, xsave, size, kXStateAVX, n, zmm + 16, 16);
+      xsave_get(pd, xsave, size, kXStateZMMHi256, n, zmm + 32, 32);
+    } else {
+      xsave_get(pd, xsave, size, kXStateHi16ZMM, n - 16, zmm, 64);
+    }
+  }
+
+  for (size_t n = 0; n < 8; n++) {
+    xsave_get(pd, xsave, size, kXStateOpmask, n, &state.kmask.regs[n],
+              sizeof(state.kmask.regs[n]));
+  }
+}
+
+static inline void
+state64_to_xsave(uint8_t *xsave, size_t size, PTracePrivateData const &pd,
+                 ds2::Architecture::X86_64::CPUState64 const &state) {
+  user_fpregs_struct fprs;
+  memcpy(&fprs, xsave, sizeof(fprs));
+  state64_to_user(fprs, state);
+  xsave_set_legacy(xsave, fprs);
+
+  for (size_t n = 0; n < 32; n++) {
+    uint8_t const *zmm = reinterpret_cast<uint8_t const *>(&state.eavx.regs[n]);
+    if (n < 16) {
+      xsave_set(pd, xsave, size, kXStateAVX, n, zmm + 16, 16);
+      xsave_set(pd, xsave, size, kXStateZMMHi256, n, zmm + 32, 32);
+    } else {
+      xsave_set(pd, xsave, size, kXStateHi16ZMM, n - 16, zmm, 64);
+    }
+  }
+
+  for (size_t n = 0; n < 8; n++) {
+    xsave_set(pd, xsave, size, kXStateOpmask, n, &state.kmask.regs[n],
+              sizeof(state.kmask.regs[n]));
+  }
+}
+
 ErrorCode PTrace::readCPUState(ProcessThreadId const &ptid,
-                               ProcessInfo const &pinfo,
-                               Architecture::CPUState &state) {
+                               ProcessArchInfo const &pinfo,
+                               Architecture::CPUState &state, uint32_t sets) {
   pid_t pid;
 
   if (!ptid.valid())
@@ -298,30 +487,58 @@ ErrorCode PTrace::readCPUState(ProcessThreadId const &ptid,
   //
   initCPUState(pid);
 
+  state.is32 = (pinfo.pointerSize == sizeof(uint32_t));
+
   //
   // Read GPRs
   //
-  user_regs_struct gprs;
-  if (wrapPtrace(PTRACE_GETREGS, pid, nullptr, &gprs) < 0)
-    return TranslateErrno();
+  if (sets & Architecture::kRegisterSetGP) {
+    user_regs_struct gprs;
+    if (wrapPtrace(PTRACE_GETREGS, pid, nullptr, &gprs) < 0)
+      return TranslateErrno();
 
-  if (pinfo.pointerSize == sizeof(uint32_t)) {
-    state.is32 = true;
-    user_to_state32(state.state32, gprs);
-  } else {
-    state.is32 = false;
-    user_to_state64(state.state64, gprs);
+    if (state.is32) {
+      user_to_state32(state.state32, gprs);
+    } else {
+      user_to_state64(state.state64, gprs);
+    }
   }
 
   //
   // Read X87 and SSE state
   //
-  user_fpregs_struct fprs;
-  if (wrapPtrace(PTRACE_GETFPREGS, pid, nullptr, &fprs) == 0) {
-    if (pinfo.pointerSize == sizeof(uint32_t)) {
-      user_to_state32(state.state32, fprs);
+  if (sets & Architecture::kRegisterSetFP) {
+    std::vector<uint8_t> &xsave = _privateData->xsave;
+    struct iovec iov = {xsave.data(), xsave.size()};
+
+    //
+    // Prefer the XSAVE area, which brings the x87, SSE, AVX and AVX-512
+    // state in a single transfer.
+    //
+    if (!xsave.empty() &&
+        wrapPtrace(PTRACE_GETREGSET, pid, NT_X86_XSTATE, &iov) == 0) {
+      if (state.is32) {
+        xsave_to_state32(state.state32, *_privateData, xsave.data(),
+                         iov.iov_len);
+      } else {
+        xsave_to_state64(state.state64, *_privateData, xsave.data(),
+                         iov.iov_len);
+      }
     } else {
-      user_to_state64(state.state64, fprs);
+      if (!xsave.empty() && errno != ESRCH) {
+        DS2LOG(Main, Debug, "NT_X86_XSTATE not available, using FPREGS");
+        xsave.clear();
+      }
+
+      user_fpregs_struct fprs;
+      if (wrapPtrace(PTRACE_GETFPREGS, pid, nullptr, &fprs) < 0)
+        return TranslateErrno();
+
+      if (state.is32) {
+        user_to_state32(state.state32, fprs);
+      } else {
+        user_to_state64(state.state64, fprs);
+      }
     }
   }
 
@@ -329,8 +546,9 @@ ErrorCode PTrace::readCPUState(ProcessThreadId const &ptid,
 }
 
 ErrorCode PTrace::writeCPUState(ProcessThreadId const &ptid,
-                                ProcessInfo const &pinfo,
-                                Architecture::CPUState const &state) {
+                                ProcessArchInfo const &pinfo,
+                                Architecture::CPUState const &state,
+                                uint32_t sets) {
   pid_t pid;
 
   if (!ptid.valid())
@@ -355,28 +573,54 @@ ErrorCode PTrace::writeCPUState(ProcessThreadId const &ptid,
   //
   // Write GPRs
   //
-  user_regs_struct gprs;
-  if (state.is32) {
-    state32_to_user(gprs, state.state32);
-  } else {
-    state64_to_user(gprs, state.state64);
-  }
+  if (sets & Architecture::kRegisterSetGP) {
+    user_regs_struct gprs;
+    if (state.is32) {
+      state32_to_user(gprs, state.state32);
+    } else {
+      state64_to_user(gprs, state.state64);
+    }
 
-  if (wrapPtrace(PTRACE_SETREGS, pid, nullptr, &gprs) < 0)
-    return TranslateErrno();
+    if (wrapPtrace(PTRACE_SETREGS, pid, nullptr, &gprs) < 0)
+      return TranslateErrno();
+  }
 
   //
   // Write X87 and SSE state
   //
-  user_fpregs_struct fprs;
-  if (state.is32) {
-    state32_to_user(fprs, state.state32);
-  } else {
-    state64_to_user(fprs, state.state64);
+  if (sets & Architecture::kRegisterSetFP) {
+    std::vector<uint8_t> &xsave = _privateData->xsave;
+    struct iovec iov = {xsave.data(), xsave.size()};
+
+    //
+    // Components we don't track must be preserved, so fetch the current
+    // XSAVE area and only patch the parts we know about.
+    //
+    if (!xsave.empty() &&
+        wrapPtrace(PTRACE_GETREGSET, pid, NT_X86_XSTATE, &iov) == 0) {
+      if (state.is32) {
+        state32_to_xsave(xsave.data(), iov.iov_len, *_privateData,
+                         state.state32);
+      } else {
+        state64_to_xsave(xsave.data(), iov.iov_len, *_privateData,
+                         state.state64);
+      }
+
+      if (wrapPtrace(PTRACE_SETREGSET, pid, NT_X86_XSTATE, &iov) < 0)
+        return TranslateErrno();
+    } else {
+      user_fpregs_struct fprs;
+      if (state.is32) {
+        state32_to_user(fprs, state.state32);
+      } else {
+        state64_to_user(fprs, state.state64);
+      }
+
+      if (wrapPtrace(PTRACE_SETFPREGS, pid, nullptr, &fprs) < 0)
+        return TranslateErrno();
+    }
   }
 
-  wrapPtrace(PTRACE_SETFPREGS, pid, nullptr, &fprs);
-
   return kSuccess;
 }
 }
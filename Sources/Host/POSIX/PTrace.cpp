@@ -50,8 +50,9 @@ ErrorCode PTrace::wait(ProcessThreadId const &ptid, bool hang, int *status) {
 // wait for the completion, read the CPU state back to grab return
 // values, then restoring the previous code.
 //
-ErrorCode PTrace::execute(ProcessThreadId const &ptid, ProcessInfo const &pinfo,
-                          void const *code, size_t length, uint64_t &result) {
+ErrorCode PTrace::execute(ProcessThreadId const &ptid,
+                          ProcessArchInfo const &pinfo, void const *code,
+                          size_t length, uint64_t &result) {
   Architecture::CPUState savedState, resultState;
   std::string savedCode;
 
@@ -59,7 +60,8 @@ ErrorCode PTrace::execute(ProcessThreadId const &ptid, ProcessInfo const &pinfo,
     return kErrorInvalidArgument;
 
   // 1. Read and save the CPU state
-  ErrorCode error = readCPUState(ptid, pinfo, savedState);
+  ErrorCode error = readCPUState(ptid, pinfo, savedState,
+                                 Architecture::kRegisterSetGP);
   if (error != kSuccess)
     return error;
 
@@ -82,7 +84,8 @@ ErrorCode PTrace::execute(ProcessThreadId const &ptid, ProcessInfo const &pinfo,
 
   if (error == kSuccess) {
     // 4. Read back the CPU state
-    error = readCPUState(ptid, pinfo, resultState);
+    error = readCPUState(ptid, pinfo, resultState,
+                         Architecture::kRegisterSetGP);
     if (error == kSuccess) {
       // 5. Save the result
       result = resultState.retval();
@@ -95,7 +98,8 @@ ErrorCode PTrace::execute(ProcessThreadId const &ptid, ProcessInfo const &pinfo,
     goto fail;
 
   // 7. Restore CPU state
-  error = writeCPUState(ptid, pinfo, savedState);
+  error =
+      writeCPUState(ptid, pinfo, savedState, Architecture::kRegisterSetGP);
   if (error != kSuccess)
     goto fail;
 
@@ -135,6 +135,15 @@ ds2::Endian Platform::GetEndian() {
 
 size_t Platform::GetPointerSize() { return sizeof(void *); }
 
+size_t Platform::GetPageSize() {
+  static size_t sPageSize = 0;
+  if (sPageSize == 0) {
+    long pageSize = ::sysconf(_SC_PAGESIZE);
+    sPageSize = (pageSize > 0) ? pageSize : 4096;
+  }
+  return sPageSize;
+}
+
 bool Platform::GetUserName(UserId const &uid, std::string &name) {
   struct passwd *pwd = ::getpwuid(uid);
   if (pwd == nullptr)
@@ -82,6 +82,16 @@ ds2::Endian Platform::GetEndian() {
 
 size_t Platform::GetPointerSize() { return sizeof(void *); }
 
+size_t Platform::GetPageSize() {
+  static size_t sPageSize = 0;
+  if (sPageSize == 0) {
+    SYSTEM_INFO info;
+    ::GetSystemInfo(&info);
+    sPageSize = info.dwPageSize;
+  }
+  return sPageSize;
+}
+
 const char *Platform::GetHostName(bool fqdn) {
   static char hostname[255] = {'\0'};
 
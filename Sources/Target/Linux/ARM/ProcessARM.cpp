@@ -262,16 +262,12 @@ ErrorCode Process::allocateMemory(size_t size, uint32_t protection,
   if (address == nullptr)
     return kErrorInvalidArgument;
 
-  ProcessInfo info;
-  ErrorCode error = getInfo(info);
-  if (error != kSuccess)
-    return error;
-
   //
   // We need to know if the process is running in Thumb or ARM mode.
   //
   Architecture::CPUState state;
-  error = ptrace().readCPUState(_pid, info, state);
+  ErrorCode error = ptrace().readCPUState(_pid, _archInfo, state,
+                                          Architecture::kRegisterSetGP);
   if (error != kSuccess)
     return error;
 
@@ -285,7 +281,9 @@ ErrorCode Process::allocateMemory(size_t size, uint32_t protection,
   //
   // Code inject and execute
   //
-  error = ptrace().execute(_pid, info, &codestr[0], codestr.size(), *address);
+  error = ptrace().execute(_pid, _archInfo, &codestr[0], codestr.size(),
+                           *address);
+  invalidateMemoryRegions();
   if (error != kSuccess)
     return error;
 
@@ -299,16 +297,12 @@ ErrorCode Process::deallocateMemory(uint64_t address, size_t size) {
   if (size == 0)
     return kErrorInvalidArgument;
 
-  ProcessInfo info;
-  ErrorCode error = getInfo(info);
-  if (error != kSuccess)
-    return error;
-
   //
   // We need to know if the process is running in Thumb or ARM mode.
   //
   Architecture::CPUState state;
-  error = ptrace().readCPUState(_pid, info, state);
+  ErrorCode error = ptrace().readCPUState(_pid, _archInfo, state,
+                                          Architecture::kRegisterSetGP);
   if (error != kSuccess)
     return error;
 
@@ -323,7 +317,10 @@ ErrorCode Process::deallocateMemory(uint64_t address, size_t size) {
   // Code inject and execute
   //
   uint64_t result = 0;
-  error = ptrace().execute(_pid, info, &codestr[0], codestr.size(), result);
+  error = ptrace().execute(_pid, _archInfo, &codestr[0], codestr.size(),
+                           result);
+  invalidateMemoryRegions();
+  invalidateMemoryCache(address, size);
   if (error != kSuccess)
     return error;
 
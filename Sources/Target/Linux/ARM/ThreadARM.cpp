@@ -341,7 +341,7 @@ PrepareARMSoftwareSingleStep(Process *process, uint32_t pc,
 ErrorCode Thread::prepareSoftwareSingleStep(Address const &address) {
   Architecture::CPUState state;
 
-  ErrorCode error = readCPUState(state);
+  ErrorCode error = readCPUState(state, Architecture::kRegisterSetGP);
   if (error != kSuccess)
     return error;
 
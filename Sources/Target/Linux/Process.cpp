@@ -19,14 +19,18 @@
 #include "DebugServer2/BreakpointManager.h"
 #include "DebugServer2/Utils/Log.h"
 
+#include <algorithm>
 #include <cerrno>
 #include <csignal>
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
 #include <elf.h>
+#include <fcntl.h>
 #include <limits>
 #include <sys/ptrace.h>
 #include <sys/wait.h>
+#include <unistd.h>
 
 using ds2::Host::Linux::PTrace;
 using ds2::Host::Linux::ProcFS;
@@ -39,9 +43,12 @@ namespace Linux {
 
 Process::Process()
     : super(), _breakpointManager(nullptr), _watchpointManager(nullptr),
-      _terminated(false) {}
+      _terminated(false), _memoryFd(-1), _memoryRegionsValid(false) {}
 
-Process::~Process() { terminate(); }
+Process::~Process() {
+  terminate();
+  closeMemoryFile();
+}
 
 ErrorCode Process::initialize(ProcessId pid, uint32_t flags) {
   //
@@ -52,7 +59,9 @@ ErrorCode Process::initialize(ProcessId pid, uint32_t flags) {
   if (error != kSuccess)
     return error;
 
-  ptrace().traceThat(pid);
+  if (!_ptrace.seized()) {
+    ptrace().traceThat(pid);
+  }
 
   error = super::initialize(pid, flags);
   if (error != kSuccess)
@@ -74,40 +83,53 @@ ErrorCode Process::attach(int waitStatus) {
     error = ptrace().wait(_pid, true, &waitStatus);
     if (error != kSuccess)
       return error;
-    ptrace().traceThat(_pid);
+    if (!_ptrace.seized()) {
+      ptrace().traceThat(_pid);
+    }
   }
 
   if (_flags & kFlagAttachedProcess) {
     //
-    // Enumerate all the tasks and create a Thread
-    // object for every entry.
-    //
-    bool keep_going = true;
-
+    // Enumerate all the tasks and create a Thread object for every entry.
+    // Each round first attaches every thread we don't know about yet, then
+    // collects their stops, so that the threads stop concurrently.
     //
     // Try to find threads of the newly attached process in multiple
     // rounds so that we avoid race conditions with threads being
-    // created before we stop the creator.
+    // created before we stop the creator; only the threads created in
+    // between are attached by the next round.
     //
+    std::vector<Thread *> attaching;
+    bool keep_going = true;
+
     while (keep_going) {
       keep_going = false;
+      attaching.clear();
 
       ProcFS::EnumerateThreads(_pid, [&](pid_t tid) {
-        //
-        // Attach the thread to the debugger and wait
-        //
         if (thread(tid) != nullptr || tid == _pid)
           return;
 
         keep_going = true;
         Thread *thread = new Thread(this, tid);
         if (ptrace().attach(tid) == kSuccess) {
-          int status;
-          ptrace().wait(tid, true, &status);
-          ptrace().traceThat(tid);
-          thread->updateTrapInfo(status);
+          attaching.push_back(thread);
         }
       });
+
+      for (auto thread : attaching) {
+        int status;
+        if (ptrace().wait(thread->tid(), true, &status) != kSuccess)
+          continue;
+
+        //
+        // Seized threads got their options when they were attached.
+        //
+        if (!_ptrace.seized()) {
+          ptrace().traceThat(thread->tid());
+        }
+        thread->updateTrapInfo(status);
+      }
     }
   }
 
@@ -117,6 +139,8 @@ ErrorCode Process::attach(int waitStatus) {
   _currentThread = new Thread(this, _pid);
   _currentThread->updateTrapInfo(waitStatus);
 
+  openMemoryFile();
+
   return kSuccess;
 }
 
@@ -149,12 +173,17 @@ static pid_t blocking_wait4(pid_t pid, int *status, int flags,
 ErrorCode Process::wait(int *rstatus, bool hang) {
   int status, signal;
   struct rusage rusage;
-  ProcessInfo info;
   ThreadId tid;
 
   // We have at least one thread when we start waiting on a process.
   DS2ASSERT(!_threads.empty());
 
+  //
+  // The inferior is about to run, so anything it maps or unmaps before the
+  // next stop must be picked up on the next region lookup.
+  //
+  invalidateMemoryRegions();
+
   while (!_threads.empty()) {
     tid = blocking_wait4(-1, &status, __WALL | (hang ? 0 : WNOHANG), &rusage);
     DS2LOG(Target, Debug, "wait tid=%d status=%#x", tid, status);
@@ -176,14 +205,12 @@ ErrorCode Process::wait(int *rstatus, bool hang) {
       // are created.
       //
       DS2LOG(Target, Debug, "creating new thread tid=%d", tid);
-      new Thread(this, tid);
+      Thread *thread = new Thread(this, tid);
 
-      if (getInfo(info) != kSuccess) {
-        DS2LOG(Target, Error, "couldn't get process info for pid %d", _pid);
-        goto continue_waiting;
+      if (ptrace().resume(ProcessThreadId(_pid, tid), _archInfo, 0) ==
+          kSuccess) {
+        thread->_state = Thread::kRunning;
       }
-
-      ptrace().resume(ProcessThreadId(_pid, tid), info, 0);
       goto continue_waiting;
     } else {
       _currentThread = threadIt->second;
@@ -191,32 +218,58 @@ ErrorCode Process::wait(int *rstatus, bool hang) {
 
     _currentThread->updateTrapInfo(status);
 
+    if (status >> 8 == (SIGTRAP | (PTRACE_EVENT_EXEC << 8))) {
+      DS2LOG(Target, Debug, "tid %d called exec", tid);
+      afterExec();
+    }
+
     switch (_currentThread->_trap.event) {
     case TrapInfo::kEventNone:
       switch (_currentThread->_trap.reason) {
+      case TrapInfo::kReasonGroupStop:
+        //
+        // The thread has been stopped by job control. Leave it stopped
+        // until it gets a SIGCONT, we'll be notified again at that point.
+        //
+        DS2LOG(Target, Debug, "thread %d entered group-stop", tid);
+        if (_ptrace.listen(ProcessThreadId(_pid, tid)) == kSuccess) {
+          _currentThread->_state = Thread::kRunning;
+        }
+        goto continue_waiting;
+
       case TrapInfo::kReasonNone:
       case TrapInfo::kReasonThreadExit:
         //
         // We should never have threads stopped for no reason
         // here, except when creating a thread. If we do, we can
         // print an error message and keep running as a
-        // best-effort solution.
+        // best-effort solution. Seized threads however can report
+        // an interrupt that raced with another stop, or a SIGCONT
+        // ending a group-stop.
         //
-        DS2LOG(Target, Error, "thread %d stopped for no reason", tid);
+        if (_ptrace.seized()) {
+          DS2LOG(Target, Debug, "thread %d stopped for no reason", tid);
+        } else {
+          DS2LOG(Target, Error, "thread %d stopped for no reason", tid);
+        }
 
       // Fall-through.
 
       case TrapInfo::kReasonThreadNew:
         //
         // This thread has been stopped because it called
-        // clone(2). Just resume it.
+        // clone(2). Just resume it, or keep stepping it if that's
+        // what it was doing.
         //
-        if (getInfo(info) != kSuccess) {
-          DS2LOG(Target, Error, "couldn't get process info for pid %d", _pid);
-          goto continue_waiting;
+        if (_currentThread->singleStepping()) {
+          if (ptrace().step(ProcessThreadId(_pid, tid), _archInfo) ==
+              kSuccess) {
+            _currentThread->_state = Thread::kStepped;
+          }
+        } else if (ptrace().resume(ProcessThreadId(_pid, tid), _archInfo) ==
+                   kSuccess) {
+          _currentThread->_state = Thread::kRunning;
         }
-
-        ptrace().resume(ProcessThreadId(_pid, tid), info);
         goto continue_waiting;
       }
 
@@ -248,11 +301,6 @@ ErrorCode Process::wait(int *rstatus, bool hang) {
       break;
 
     case TrapInfo::kEventStop:
-      if (getInfo(info) != kSuccess) {
-        DS2LOG(Target, Error, "couldn't get process info for pid %d", _pid);
-        goto continue_waiting;
-      }
-
       signal = _currentThread->_trap.signal;
 
       if (signal == SIGSTOP || signal == SIGCHLD || signal == SIGRTMIN) {
@@ -272,9 +320,14 @@ ErrorCode Process::wait(int *rstatus, bool hang) {
         // only for SIGSTOP, SIGCHLD and SIGRTMIN, but for every
         // signal that we choose to ignore.
         //
-        bool stepping = (_currentThread->state() == Thread::kStepped);
+        bool stepping = _currentThread->singleStepping();
 
-        if (signal == SIGSTOP) {
+        //
+        // Seized threads are never stopped with SIGSTOP by us, so this
+        // one comes from somewhere else and is delivered; the resulting
+        // group-stop is then handled above.
+        //
+        if (signal == SIGSTOP && !_ptrace.seized()) {
           signal = 0;
         } else {
           DS2LOG(Target, Debug,
@@ -285,19 +338,26 @@ ErrorCode Process::wait(int *rstatus, bool hang) {
 
         ErrorCode error;
         if (stepping) {
-          error = ptrace().step(ProcessThreadId(_pid, tid), info, signal);
+          error = ptrace().step(ProcessThreadId(_pid, tid), _archInfo, signal);
         } else {
-          error = ptrace().resume(ProcessThreadId(_pid, tid), info, signal);
+          error =
+              ptrace().resume(ProcessThreadId(_pid, tid), _archInfo, signal);
         }
 
         if (error != kSuccess) {
           DS2LOG(Target, Warning, "cannot resume thread %d error=%d", tid,
                  error);
+        } else {
+          _currentThread->_state =
+              stepping ? Thread::kStepped : Thread::kRunning;
         }
 
         goto continue_waiting;
       } else if (_passthruSignals.find(signal) != _passthruSignals.end()) {
-        ptrace().resume(ProcessThreadId(_pid, tid), info, signal);
+        if (ptrace().resume(ProcessThreadId(_pid, tid), _archInfo, signal) ==
+            kSuccess) {
+          _currentThread->_state = Thread::kRunning;
+        }
         goto continue_waiting;
       } else {
         //
@@ -325,6 +385,7 @@ ErrorCode Process::wait(int *rstatus, bool hang) {
 
   if ((WIFEXITED(status) || WIFSIGNALED(status)) && tid == _pid) {
     _terminated = true;
+    closeMemoryFile();
   }
 
   if (rstatus != nullptr) {
@@ -361,44 +422,74 @@ bool Process::isAlive() const {
   return super::isAlive();
 }
 
+//
+// Threads are stopped in two passes so that they all stop concurrently: the
+// first pass sends SIGSTOP to every running thread, the second collects the
+// stop notifications. A thread may report another event (e.g. a breakpoint)
+// before it gets our SIGSTOP; that event is recorded in its trap info like
+// any other, and the pending SIGSTOP is ignored by wait once it is resumed.
+//
 ErrorCode Process::suspend() {
   std::set<Thread *> threads;
   enumerateThreads([&](Thread *thread) { threads.insert(thread); });
 
+  std::vector<Thread *> stopping;
   for (auto thread : threads) {
-    Architecture::CPUState state;
-    if (thread->state() != Thread::kRunning) {
-      thread->readCPUState(state);
-    }
-    DS2LOG(Target, Debug, "tid %d state %d at pc %#llx", thread->tid(),
-           thread->state(),
-           thread->state() == Thread::kStopped ? (unsigned long long)state.pc()
-                                               : 0);
-    if (thread->state() == Thread::kRunning) {
-      ErrorCode error;
+    DS2LOG(Target, Debug, "tid %d state %d", thread->tid(), thread->state());
 
+    switch (thread->state()) {
+    case Thread::kRunning:
+    case Thread::kStepped: {
+      //
+      // A thread that is being stepped hasn't necessarily reported its stop
+      // yet; the state is only known from wait(2) events.
+      //
       DS2LOG(Target, Debug, "suspending tid %d", thread->tid());
-      error = thread->suspend();
-
+      ErrorCode error = ptrace().suspend(ProcessThreadId(_pid, thread->tid()));
       if (error == kSuccess) {
-        DS2LOG(Target, Debug, "suspended tid %d at pc %#llx", thread->tid(),
-               (unsigned long long)state.pc());
-        thread->readCPUState(state);
+        stopping.push_back(thread);
       } else if (error == kErrorProcessNotFound) {
         //
         // Thread is dead.
         //
-        removeThread(thread->tid());
-        DS2LOG(Target, Debug, "tried to suspended tid %d which is already dead",
+        DS2LOG(Target, Debug, "tried to suspend tid %d which is already dead",
                thread->tid());
+        removeThread(thread->tid());
       } else {
         return error;
       }
-    } else if (thread->state() == Thread::kTerminated) {
+    } break;
+
+    case Thread::kTerminated:
       //
       // Thread is dead.
       //
       removeThread(thread->tid());
+      break;
+
+    default:
+      break;
+    }
+  }
+
+  for (auto thread : stopping) {
+    int status;
+    ErrorCode error =
+        ptrace().wait(ProcessThreadId(_pid, thread->tid()), true, &status);
+    if (error != kSuccess) {
+      DS2LOG(Target, Error, "failed to wait for tid %d, error=%s",
+             thread->tid(), strerror(errno));
+      removeThread(thread->tid());
+      continue;
+    }
+
+    thread->updateTrapInfo(status);
+    if (thread->state() == Thread::kTerminated) {
+      DS2LOG(Target, Debug, "tid %d exited while being suspended",
+             thread->tid());
+      removeThread(thread->tid());
+    } else {
+      DS2LOG(Target, Debug, "suspended tid %d", thread->tid());
     }
   }
 
@@ -413,7 +504,7 @@ ErrorCode Process::resume(int signal, std::set<Thread *> const &excluded) {
     if (thread->state() == Thread::kStopped ||
         thread->state() == Thread::kStepped) {
       Architecture::CPUState state;
-      thread->readCPUState(state);
+      thread->readCPUState(state, Architecture::kRegisterSetGP);
       DS2LOG(Target, Debug, "resuming tid %d from pc %#llx", thread->tid(),
              (unsigned long long)state.pc());
       ErrorCode error = thread->resume(signal);
@@ -466,108 +557,292 @@ ErrorCode Process::updateAuxiliaryVector() {
   return kSuccess;
 }
 
+//
+// The process information is only read once per program image; afterExec
+// invalidates it.
+//
 ErrorCode Process::updateInfo() {
-  //
-  // Some info like parent pid, OS vendor, etc is obtained via /proc.
-  //
-  ProcFS::ReadProcessInfo(_info.pid, _info);
-
   //
   // Call super::updateInfo, in turn it will call updateAuxiliaryVector.
   //
   ErrorCode error = super::updateInfo();
-  if (error != kSuccess && error != kErrorAlreadyExist)
+  if (error == kErrorAlreadyExist)
+    return kSuccess;
+  if (error != kSuccess)
     return error;
 
+  //
+  // Some info like parent pid, OS vendor, etc is obtained via /proc; the
+  // architecture and ids were already read from the ELF image.
+  //
+  ProcessInfo info;
+  if (ProcFS::ReadProcessInfo(_pid, info)) {
+    _info.parentPid = info.parentPid;
+    _info.name.swap(info.name);
+    _info.osType.swap(info.osType);
+    _info.osVendor.swap(info.osVendor);
+  }
+
   return kSuccess;
 }
 
-ErrorCode Process::getMemoryRegionInfo(Address const &address,
-                                       MemoryRegionInfo &info) {
-  if (!address.valid())
-    return kErrorInvalidArgument;
+ErrorCode Process::updateMemoryRegions() {
+  if (_memoryRegionsValid)
+    return kSuccess;
 
-  info.clear();
+  _memoryRegions.clear();
 
-  FILE *fp = ProcFS::OpenFILE(_pid, "maps");
-  if (fp == nullptr) {
+  bool success = ProcFS::EnumerateMemoryRegions(
+      _pid, [this](MemoryRegionInfo const &region) {
+        _memoryRegions.push_back(region);
+      });
+  if (!success) {
     switch (errno) {
     case ESRCH:
+    case ENOENT:
       return kErrorProcessNotFound;
     default:
       return kErrorUnsupported;
     }
   }
 
-  uint64_t last = 0;
-  bool found = false;
+  //
+  // The kernel already lists mappings in address order, but the lookup
+  // below relies on it so don't take it for granted.
+  //
+  auto compare = [](MemoryRegionInfo const &lhs, MemoryRegionInfo const &rhs) {
+    return lhs.start.value() < rhs.start.value();
+  };
+  if (!std::is_sorted(_memoryRegions.begin(), _memoryRegions.end(), compare)) {
+    std::sort(_memoryRegions.begin(), _memoryRegions.end(), compare);
+  }
 
-  while (!found) {
-    char buf[128];
-    unsigned long long start, end;
-    char r, w, x;
+  DS2LOG(Target, Debug, "indexed %zu memory regions for pid %d",
+         _memoryRegions.size(), _pid);
 
-    if (std::fgets(buf, sizeof(buf), fp) == nullptr)
-      break;
+  _memoryRegionsValid = true;
+  return kSuccess;
+}
 
-    if (std::sscanf(buf, "%llx-%llx %c%c%c", &start, &end, &r, &w, &x) != 5)
-      continue;
+void Process::invalidateMemoryRegions() {
+  _memoryRegionsValid = false;
+}
 
-    if (address >= last && address <= start) {
-      //
-      // A hole.
-      //
-      info.start = last;
-      info.length = start - last;
-      found = true;
-    } else if (address >= start && address < end) {
+ErrorCode Process::getMemoryRegionInfo(Address const &address,
+                                       MemoryRegionInfo &info) {
+  if (!address.valid())
+    return kErrorInvalidArgument;
+
+  info.clear();
+
+  ErrorCode error = updateMemoryRegions();
+  if (error != kSuccess)
+    return error;
+
+  //
+  // Find the first region starting after the address; the region before it,
+  // if any, is the only one that can contain the address.
+  //
+  uint64_t value = address.value();
+  auto it = std::upper_bound(
+      _memoryRegions.begin(), _memoryRegions.end(), value,
+      [](uint64_t value, MemoryRegionInfo const &region) {
+        return value < region.start.value();
+      });
+
+  uint64_t last = 0;
+  if (it != _memoryRegions.begin()) {
+    MemoryRegionInfo const &region = *(it - 1);
+    if (value < region.start.value() + region.length) {
       //
       // A defined region.
       //
-      info.start = start;
-      info.length = end - start;
-      info.protection = 0;
-      if (r == 'r')
-        info.protection |= ds2::kProtectionRead;
-      if (w == 'w')
-        info.protection |= ds2::kProtectionWrite;
-      if (x == 'x')
-        info.protection |= ds2::kProtectionExecute;
-      found = true;
-    } else {
-      last = end;
+      info = region;
+      return kSuccess;
     }
+    last = region.start.value() + region.length;
   }
-  std::fclose(fp);
 
-  if (!found) {
-    info.start = last;
+  info.start = last;
 
+  if (it != _memoryRegions.end()) {
     //
-    // We need to obtain the end of the address space, first
-    // we need to know if it's 64-bit.
+    // A hole.
     //
-    ErrorCode error = updateInfo();
-    if (error != kSuccess && error != kErrorAlreadyExist)
-      return error;
+    info.length = it->start.value() - last;
+    return kSuccess;
+  }
 
-    if (CPUTypeIs64Bit(_info.cpuType)) {
-      info.length = std::numeric_limits<uint64_t>::max() - info.start;
-    } else {
-      info.length = std::numeric_limits<uint32_t>::max() - info.start;
-    }
+  //
+  // We need to obtain the end of the address space, first
+  // we need to know if it's 64-bit.
+  //
+  error = updateInfo();
+  if (error != kSuccess && error != kErrorAlreadyExist)
+    return error;
+
+  if (CPUTypeIs64Bit(_info.cpuType)) {
+    info.length = std::numeric_limits<uint64_t>::max() - info.start;
+  } else {
+    info.length = std::numeric_limits<uint32_t>::max() - info.start;
   }
 
   return kSuccess;
 }
 
+ErrorCode Process::enumerateMemoryRegions(
+    std::function<void(MemoryRegionInfo const &)> const &cb) {
+  ErrorCode error = updateMemoryRegions();
+  if (error != kSuccess)
+    return error;
+
+  for (auto const &region : _memoryRegions) {
+    cb(region);
+  }
+
+  return kSuccess;
+}
+
+void Process::afterExec() {
+  //
+  // The new program image lives in a new address space; the memory file
+  // we had open refers to the old one.
+  //
+  closeMemoryFile();
+  openMemoryFile();
+  invalidateMemoryCache();
+  invalidateMemoryRegions();
+
+  super::afterExec();
+}
+
+ErrorCode Process::beforeResume() {
+  size_t hits = 0, misses = 0;
+
+  enumerateThreads([&](Thread *thread) {
+    hits += thread->_cpuStateHits;
+    misses += thread->_cpuStateMisses;
+    thread->_cpuStateHits = thread->_cpuStateMisses = 0;
+  });
+
+  DS2LOG(Target, Debug, "CPU state cache: %llu hits, %llu misses",
+         (unsigned long long)hits, (unsigned long long)misses);
+
+  return super::beforeResume();
+}
+
+void Process::prepareForDetach() {
+  //
+  // Registers written by the debugger since the last stop are only applied
+  // when a thread resumes; make sure they are not lost on detach.
+  //
+  enumerateThreads([](Thread *thread) { thread->flushCPUState(); });
+
+  super::prepareForDetach();
+}
+
+void Process::openMemoryFile() {
+  closeMemoryFile();
+
+  _memoryFd = ProcFS::OpenFd(_pid, "mem", O_RDWR | O_CLOEXEC);
+  if (_memoryFd < 0) {
+    DS2LOG(Target, Debug, "unable to open /proc/%d/mem, error=%s", _pid,
+           strerror(errno));
+  }
+}
+
+void Process::closeMemoryFile() {
+  if (_memoryFd < 0)
+    return;
+
+  ::close(_memoryFd);
+  _memoryFd = -1;
+}
+
+//
+// /proc/<pid>/mem goes through the same access path as ptrace(2) so it can
+// read and write any mapped page, including read-only text, but it does so
+// for arbitrary lengths in a single system call.
+//
+ErrorCode Process::readMemoryFile(Address const &address, void *data,
+                                  size_t length, size_t &nread) {
+  nread = 0;
+
+  if (_memoryFd < 0)
+    return kErrorUnsupported;
+
+  while (nread < length) {
+    ssize_t ret = ::pread64(_memoryFd, static_cast<uint8_t *>(data) + nread,
+                            length - nread, address.value() + nread);
+    if (ret < 0 && errno == EINTR)
+      continue;
+    if (ret < 0)
+      return (nread > 0) ? kSuccess : kErrorInvalidAddress;
+    if (ret == 0)
+      break;
+    nread += ret;
+  }
+
+  return (nread > 0 || length == 0) ? kSuccess : kErrorInvalidAddress;
+}
+
+ErrorCode Process::writeMemoryFile(Address const &address, void const *data,
+                                   size_t length, size_t &nwritten) {
+  nwritten = 0;
+
+  if (_memoryFd < 0)
+    return kErrorUnsupported;
+
+  while (nwritten < length) {
+    ssize_t ret =
+        ::pwrite64(_memoryFd, static_cast<uint8_t const *>(data) + nwritten,
+                   length - nwritten, address.value() + nwritten);
+    if (ret < 0 && errno == EINTR)
+      continue;
+    if (ret < 0)
+      return (nwritten > 0) ? kSuccess : kErrorInvalidAddress;
+    if (ret == 0)
+      break;
+    nwritten += ret;
+  }
+
+  return (nwritten > 0 || length == 0) ? kSuccess : kErrorInvalidAddress;
+}
+
 ErrorCode Process::readMemory(Address const &address, void *data, size_t length,
                               size_t *count) {
   if (_currentThread == nullptr)
     return super::readMemory(address, data, length, count);
 
-  return ptrace().readMemory(_currentThread->tid(), address, data, length,
-                             count);
+  //
+  // Use the memory file when it is open; anything it cannot transfer is
+  // retried through ptrace, which reports the precise error.
+  //
+  size_t nread = 0;
+  if (readMemoryFile(address, data, length, nread) == kSuccess &&
+      nread == length) {
+    if (count != nullptr) {
+      *count = nread;
+    }
+    return kSuccess;
+  }
+
+  size_t nremaining = 0;
+  ErrorCode error = ptrace().readMemory(
+      _currentThread->tid(), address + nread,
+      static_cast<uint8_t *>(data) + nread, length - nread, &nremaining);
+  if (error != kSuccess && nread == 0)
+    return error;
+
+  nread += (error == kSuccess) ? nremaining : 0;
+  if (nread < length && count == nullptr)
+    return (error != kSuccess) ? error : kErrorInvalidAddress;
+
+  if (count != nullptr) {
+    *count = nread;
+  }
+
+  return kSuccess;
 }
 
 ErrorCode Process::writeMemory(Address const &address, void const *data,
@@ -575,8 +850,34 @@ ErrorCode Process::writeMemory(Address const &address, void const *data,
   if (_currentThread == nullptr)
     return super::writeMemory(address, data, length, count);
 
-  return ptrace().writeMemory(_currentThread->tid(), address, data, length,
-                              count);
+  invalidateMemoryCache(address, length);
+
+  size_t nwritten = 0;
+  if (writeMemoryFile(address, data, length, nwritten) == kSuccess &&
+      nwritten == length) {
+    if (count != nullptr) {
+      *count = nwritten;
+    }
+    return kSuccess;
+  }
+
+  size_t nremaining = 0;
+  ErrorCode error = ptrace().writeMemory(
+      _currentThread->tid(), address + nwritten,
+      static_cast<uint8_t const *>(data) + nwritten, length - nwritten,
+      &nremaining);
+  if (error != kSuccess && nwritten == 0)
+    return error;
+
+  nwritten += (error == kSuccess) ? nremaining : 0;
+  if (nwritten < length && count == nullptr)
+    return (error != kSuccess) ? error : kErrorInvalidAddress;
+
+  if (count != nullptr) {
+    *count = nwritten;
+  }
+
+  return kSuccess;
 }
 }
 }
@@ -28,7 +28,9 @@ namespace ds2 {
 namespace Target {
 namespace Linux {
 
-Thread::Thread(Process *process, ThreadId tid) : super(process, tid) {
+Thread::Thread(Process *process, ThreadId tid)
+    : super(process, tid), _cpuStateLoaded(0), _cpuStateModified(0),
+      _cpuStateHits(0), _cpuStateMisses(0) {
   //
   // Initially the thread is stopped.
   //
@@ -44,7 +46,7 @@ ErrorCode Thread::terminate() {
 
 ErrorCode Thread::suspend() {
   ErrorCode error = kSuccess;
-  if (_state == kRunning) {
+  if (_state == kRunning || _state == kStepped) {
     error =
         process()->ptrace().suspend(ProcessThreadId(process()->pid(), tid()));
     if (error != kSuccess)
@@ -73,18 +75,18 @@ ErrorCode Thread::step(int signal, Address const &address) {
   ErrorCode error = kSuccess;
   if (_state == kStopped || _state == kStepped) {
     DS2LOG(Target, Debug, "stepping tid %d", tid());
-    if (process()->isSingleStepSupported()) {
-      ProcessInfo info;
-
-      error = process()->getInfo(info);
-      if (error != kSuccess)
-        return error;
+    error = flushCPUState();
+    if (error != kSuccess)
+      return error;
 
+    if (process()->isSingleStepSupported()) {
       error = process()->ptrace().step(ProcessThreadId(process()->pid(), tid()),
-                                       info, signal, address);
+                                       process()->archInfo(), signal, address);
 
       if (error == kSuccess) {
         _state = kStepped;
+        _singleStepping = true;
+        invalidateCPUState();
       }
     } else {
       //
@@ -96,6 +98,9 @@ ErrorCode Thread::step(int signal, Address const &address) {
         return error;
 
       error = resume(signal, address);
+      if (error == kSuccess) {
+        _singleStepping = true;
+      }
     }
   } else if (_state == kTerminated) {
     error = kErrorProcessNotFound;
@@ -119,17 +124,17 @@ ErrorCode Thread::resume(int signal, Address const &address) {
       }
     }
 
-    ProcessInfo info;
-
-    error = process()->getInfo(info);
+    error = flushCPUState();
     if (error != kSuccess)
       return error;
 
     error = process()->ptrace().resume(ProcessThreadId(process()->pid(), tid()),
-                                       info, signal, address);
+                                       process()->archInfo(), signal, address);
     if (error == kSuccess) {
       _state = kRunning;
+      _singleStepping = false;
       _trap.signal = 0;
+      invalidateCPUState();
     }
   } else if (_state == kTerminated) {
     error = kErrorProcessNotFound;
@@ -137,35 +142,77 @@ ErrorCode Thread::resume(int signal, Address const &address) {
   return error;
 }
 
-ErrorCode Thread::readCPUState(Architecture::CPUState &state) {
-  // TODO cache CPU state
-  ProcessInfo info;
-  ErrorCode error;
+//
+// Registers are read at most once per stop, one register set at a time and
+// only when a caller asks for it; the copy we keep is valid until the thread
+// runs again. Writes only update the copy and mark the sets they touch as
+// modified, those are written back right before the thread is resumed or
+// stepped.
+//
+ErrorCode Thread::readCPUState(Architecture::CPUState &state, uint32_t sets) {
+  uint32_t missing = sets & ~_cpuStateLoaded;
+
+  if (missing == 0) {
+    _cpuStateHits++;
+    state = _cpuState;
+    return kSuccess;
+  }
 
-  error = _process->getInfo(info);
+  ErrorCode error = process()->ptrace().readCPUState(
+      ProcessThreadId(process()->pid(), tid()), process()->archInfo(),
+      _cpuState, missing);
   if (error != kSuccess)
     return error;
 
-  return process()->ptrace().readCPUState(
-      ProcessThreadId(process()->pid(), tid()), info, state);
+  _cpuStateMisses++;
+  _cpuStateLoaded |= missing;
+  state = _cpuState;
+  return kSuccess;
 }
 
-ErrorCode Thread::writeCPUState(Architecture::CPUState const &state) {
-  ProcessInfo info;
-  ErrorCode error;
+//
+// Only the given sets are taken from state, the others are kept as they were
+// loaded; a caller that read fewer sets can't clobber them with stale values.
+//
+ErrorCode Thread::writeCPUState(Architecture::CPUState const &state,
+                                uint32_t sets) {
+  _cpuState.copyRegisterSets(state, sets);
+  _cpuStateLoaded |= sets;
+  _cpuStateModified |= sets;
+  return kSuccess;
+}
 
-  error = _process->getInfo(info);
-  if (error != kSuccess)
+ErrorCode Thread::flushCPUState() {
+  if (_cpuStateModified == 0)
+    return kSuccess;
+
+  ErrorCode error = process()->ptrace().writeCPUState(
+      ProcessThreadId(process()->pid(), tid()), process()->archInfo(),
+      _cpuState, _cpuStateModified);
+  if (error != kSuccess) {
+    DS2LOG(Target, Error, "unable to write CPU state of tid %d, error=%d",
+           tid(), error);
     return error;
+  }
+
+  _cpuStateModified = 0;
+  return kSuccess;
+}
 
-  return process()->ptrace().writeCPUState(
-      ProcessThreadId(process()->pid(), tid()), info, state);
+void Thread::invalidateCPUState() {
+  _cpuStateLoaded = 0;
+  _cpuStateModified = 0;
 }
 
 ErrorCode Thread::updateTrapInfo(int waitStatus) {
   ErrorCode error = kSuccess;
   siginfo_t si;
 
+  //
+  // The thread ran since we last looked at its registers.
+  //
+  invalidateCPUState();
+
   super::updateTrapInfo(waitStatus);
 
   //
@@ -184,7 +231,41 @@ ErrorCode Thread::updateTrapInfo(int waitStatus) {
     _trap.reason = TrapInfo::kReasonThreadNew;
   }
 
-  updateState(true);
+  //
+  // Seized threads report PTRACE_EVENT_STOP when they are interrupted, when
+  // they are first attached and when they enter a group-stop. None of these
+  // are signals the inferior has to see; group-stops are the only ones that
+  // carry a stop signal instead of SIGTRAP.
+  //
+  if (waitStatus >> 16 == PTRACE_EVENT_STOP) {
+    switch (_trap.signal) {
+    case SIGSTOP:
+    case SIGTSTP:
+    case SIGTTIN:
+    case SIGTTOU:
+      _trap.reason = TrapInfo::kReasonGroupStop;
+      break;
+    default:
+      break;
+    }
+    _trap.event = TrapInfo::kEventNone;
+    _trap.signal = 0;
+  }
+
+  //
+  // The wait status tells us everything we need to know about the state of
+  // the thread, there's no need to look at /proc.
+  //
+  switch (_trap.event) {
+  case TrapInfo::kEventExit:
+  case TrapInfo::kEventKill:
+  case TrapInfo::kEventCoreDump:
+    _state = kTerminated;
+    break;
+  default:
+    _state = kStopped;
+    break;
+  }
 
   if (_trap.event == TrapInfo::kEventStop) {
     ProcessThreadId ptid(process()->pid(), tid());
@@ -232,44 +313,12 @@ ErrorCode Thread::updateTrapInfo(int waitStatus) {
   return error;
 }
 
-void Thread::updateState() { updateState(false); }
-
-void Thread::updateState(bool force) {
-  if (!process()->isAlive()) {
-    _state = kTerminated;
-    return;
-  }
-
+uint32_t Thread::core() const {
   ProcFS::Stat stat;
-  if (!ProcFS::ReadStat(_process->pid(), tid(), stat)) {
-    stat.task_cpu = 0;
-    stat.state = 0;
-  }
-
-  _trap.core = stat.task_cpu;
-
-  switch (stat.state) {
-  case Host::Linux::kProcStateZombie:
-  case Host::Linux::kProcStateDead:
-    _state = kTerminated;
-    break;
-
-  case Host::Linux::kProcStateUninterruptible:
-  case Host::Linux::kProcStateSleeping:
-  case Host::Linux::kProcStateRunning:
-  case Host::Linux::kProcStatePaging:
-    _state = kRunning;
-    break;
+  if (!ProcFS::ReadStat(_process->pid(), tid(), stat))
+    return 0;
 
-  case Host::Linux::kProcStateTraced:
-  case Host::Linux::kProcStateStopped:
-    _state = kStopped;
-    break;
-
-  default:
-    _state = kInvalid;
-    break;
-  }
+  return stat.task_cpu;
 }
 }
 }
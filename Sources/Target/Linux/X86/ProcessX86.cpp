@@ -71,18 +71,15 @@ ErrorCode Process::allocateMemory(size_t size, uint32_t protection,
   if (address == nullptr)
     return kErrorInvalidArgument;
 
-  ProcessInfo info;
-  ErrorCode error = getInfo(info);
-  if (error != kSuccess)
-    return error;
-
   U8Vector codestr;
   PrepareMmapCode(size, protection, codestr);
 
   //
   // Code inject and execute
   //
-  error = ptrace().execute(_pid, info, &codestr[0], codestr.size(), *address);
+  ErrorCode error = ptrace().execute(_pid, _archInfo, &codestr[0],
+                                     codestr.size(), *address);
+  invalidateMemoryRegions();
   if (error != kSuccess)
     return error;
 
@@ -96,11 +93,6 @@ ErrorCode Process::deallocateMemory(uint64_t address, size_t size) {
   if (size == 0)
     return kErrorInvalidArgument;
 
-  ProcessInfo info;
-  ErrorCode error = getInfo(info);
-  if (error != kSuccess)
-    return error;
-
   U8Vector codestr;
   PrepareMunmapCode(address, size, codestr);
 
@@ -108,7 +100,10 @@ ErrorCode Process::deallocateMemory(uint64_t address, size_t size) {
   // Code inject and execute
   //
   uint64_t result = 0;
-  error = ptrace().execute(_pid, info, &codestr[0], codestr.size(), result);
+  ErrorCode error = ptrace().execute(_pid, _archInfo, &codestr[0],
+                                     codestr.size(), result);
+  invalidateMemoryRegions();
+  invalidateMemoryCache(address, size);
   if (error != kSuccess)
     return error;
 
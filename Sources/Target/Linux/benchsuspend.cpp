@@ -0,0 +1,105 @@
+//
+// Copyright (c) 2014, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the University of Illinois/NCSA Open
+// Source License found in the LICENSE file in the root directory of this
+// source tree. An additional grant of patent rights can be found in the
+// PATENTS file in the same directory.
+//
+
+#include "DebugServer2/Target/Process.h"
+#include "DebugServer2/Target/Thread.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <vector>
+
+using ds2::Target::Process;
+
+static void *Spin(void *) {
+  for (;;) {
+    sched_yield();
+  }
+  return nullptr;
+}
+
+//
+// Forks an inferior running the given number of threads, all of them
+// spinning, and returns its pid once they are all started.
+//
+static pid_t SpawnInferior(size_t nthreads) {
+  int fds[2];
+  if (pipe(fds) < 0)
+    return -1;
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    for (size_t n = 1; n < nthreads; n++) {
+      pthread_t thread;
+      pthread_create(&thread, nullptr, Spin, nullptr);
+    }
+    char c = 0;
+    write(fds[1], &c, 1);
+    Spin(nullptr);
+  }
+
+  char c;
+  read(fds[0], &c, 1);
+  close(fds[0]);
+  close(fds[1]);
+  return pid;
+}
+
+//
+// Times Process::suspend on a running inferior; the whole inferior is
+// resumed and left running for a while before each measure.
+//
+int main(int argc, char **argv) {
+  size_t iterations = (argc > 1) ? std::strtoul(argv[1], nullptr, 0) : 50;
+  static size_t const counts[] = {1, 16, 64, 256};
+
+  printf("%8s %12s %12s\n", "threads", "median us", "max us");
+  for (size_t nthreads : counts) {
+    pid_t pid = SpawnInferior(nthreads);
+    Process *process = Process::Attach(pid);
+    if (process == nullptr) {
+      printf("cannot attach to %d\n", pid);
+      kill(pid, SIGKILL);
+      return 1;
+    }
+
+    std::vector<double> latencies;
+    for (size_t n = 0; n < iterations; n++) {
+      if (process->resume() != ds2::kSuccess)
+        break;
+      usleep(10000);
+
+      auto start = std::chrono::steady_clock::now();
+      ds2::ErrorCode error = process->suspend();
+      std::chrono::duration<double, std::micro> elapsed =
+          std::chrono::steady_clock::now() - start;
+      if (error != ds2::kSuccess)
+        break;
+      latencies.push_back(elapsed.count());
+    }
+
+    process->terminate();
+    delete process;
+
+    if (latencies.empty()) {
+      printf("%8zu %12s %12s\n", nthreads, "-", "-");
+      continue;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    printf("%8zu %12.0f %12.0f\n", nthreads, latencies[latencies.size() / 2],
+           latencies.back());
+  }
+
+  return 0;
+}
@@ -8,13 +8,20 @@
 // PATENTS file in the same directory.
 //
 
+#define __DS2_LOG_CLASS_NAME__ "Target::ELFProcess"
+
+#include "DebugServer2/BreakpointManager.h"
 #include "DebugServer2/Support/POSIX/ELFSupport.h"
 #include "DebugServer2/Target/POSIX/ELFProcess.h"
+#include "DebugServer2/Target/Thread.h"
+#include "DebugServer2/Utils/Log.h"
 
+#include <csignal>
 #include <dirent.h>
 #include <elf.h>
 #include <limits>
 #include <link.h>
+#include <map>
 
 using ds2::Support::ELFSupport;
 
@@ -156,61 +163,95 @@ inline ErrorCode ReadELFLinkMap(ELFProcess *process, Address address,
   return process->readMemory(address, &linkMap, sizeof(linkMap));
 }
 
+//
+// Values of r_debug.r_state.
+//
+enum {
+  kRendezvousConsistent = 0,
+  kRendezvousAdd = 1,
+  kRendezvousDelete = 2,
+};
+
+//
+// Pointer-size independent view of the fields of r_debug we use.
+//
+struct Rendezvous {
+  uint64_t mapAddress;
+  uint64_t brk;
+  int state;
+};
+
 template <typename T>
-ErrorCode EnumerateLinkMap(
-    ELFProcess *process, Address addressToDPtr,
-    std::function<void(ELFProcess::SharedLibrary const &)> const &cb) {
+ErrorCode ReadRendezvous(ELFProcess *process, Address addressToDPtr,
+                         Rendezvous &rendezvous) {
   ELFDebug<T> debug;
-  ELFLinkMap<T> linkMap;
   T address;
-  T linkMapAddress;
-  bool isMain = true;
 
   ErrorCode error =
       process->readMemory(addressToDPtr, &address, sizeof(address));
   if (error != ds2::kSuccess)
     return error;
 
+  //
+  // DT_DEBUG is filled by the dynamic linker when it starts.
+  //
+  if (address == 0)
+    return ds2::kErrorNotFound;
+
   error = ReadELFDebug(process, address, debug);
   if (error != ds2::kSuccess)
     return error;
 
 #if !defined(__ANDROID__)
-  if (debug.version != LAV_CURRENT)
+  //
+  // r_version stays 0 until the dynamic linker has set the structure up;
+  // it is 1 afterwards, or 2 when linker namespaces are in use. It is not
+  // related to LAV_CURRENT, which is the audit interface version.
+  //
+  if (debug.version == 0)
     return ds2::kErrorUnsupported;
 #endif
 
-  linkMapAddress = debug.mapAddress;
-  while (linkMapAddress != 0) {
-    char nameBuffer[PATH_MAX + 1];
-
-    error = ReadELFLinkMap(process, linkMapAddress, linkMap);
-    if (error != ds2::kSuccess)
-      return error;
-
-    ELFProcess::SharedLibrary shlib;
-    shlib.main = isMain;
-    shlib.sections.clear();
-    shlib.svr4.mapAddress = linkMapAddress;
-    shlib.svr4.baseAddress = linkMap.baseAddress;
-    shlib.svr4.ldAddress = linkMap.ldAddress;
-
-    error = process->readMemory(linkMap.nameAddress, nameBuffer, PATH_MAX);
-    if (error != ds2::kSuccess)
-      return error;
-
-    shlib.path = nameBuffer;
+  rendezvous.mapAddress = debug.mapAddress;
+  rendezvous.brk = debug.brk;
+  rendezvous.state = debug.state;
+  return ds2::kSuccess;
+}
 
-    cb(shlib);
+template <typename T>
+ErrorCode ReadLinkMapEntry(ELFProcess *process, uint64_t address,
+                           ELFProcess::SharedLibrary &shlib,
+                           uint64_t &nextAddress) {
+  ELFLinkMap<T> linkMap;
 
-    linkMapAddress = linkMap.nextAddress;
-    isMain = false;
-  }
+  ErrorCode error = ReadELFLinkMap(process, address, linkMap);
+  if (error != ds2::kSuccess)
+    return error;
 
+  shlib.main = false;
+  shlib.sections.clear();
+  shlib.svr4.mapAddress = address;
+  shlib.svr4.baseAddress = linkMap.baseAddress;
+  shlib.svr4.ldAddress = linkMap.ldAddress;
+  shlib.svr4.nameAddress = linkMap.nameAddress;
+  nextAddress = linkMap.nextAddress;
   return ds2::kSuccess;
 }
+
+//
+// Upper bound on the number of link map entries, in case the list is
+// corrupted and loops.
+//
+static size_t const kMaxLinkMapEntries = 1 << 16;
 }
 
+#define super ds2::Target::POSIX::Process
+
+ELFProcess::ELFProcess()
+    : super(), _sharedLibrariesValid(false), _sharedLibrariesAdded(false),
+      _sharedLibraryTrackingUnsupported(false),
+      _sharedLibraryBreakpointDisarmed(false), _internalStop(false) {}
+
 //
 // This is a SVR4 ELF process, we want this method because GDB
 // distinguishes between SVR4 and non-SVR4 processes to read
@@ -299,6 +340,22 @@ ErrorCode ELFProcess::updateInfo() {
     MemoryRegionInfo mri;
     error = getMemoryRegionInfo(_entryPoint, mri);
 
+    //
+    // The entry point is not necessarily in the first mapping of the
+    // executable (e.g. when text is mapped separately from the ELF
+    // header), so walk back by the file offset to the mapping of offset 0
+    // of the same file.
+    //
+    if (error == kSuccess && mri.offset != 0 && mri.inode != 0 &&
+        mri.offset <= mri.start.value()) {
+      MemoryRegionInfo head;
+      if (getMemoryRegionInfo(mri.start.value() - mri.offset, head) ==
+              kSuccess &&
+          head.inode == mri.inode && head.offset == 0) {
+        mri = head;
+      }
+    }
+
     //
     // Restore the hack.
     //
@@ -373,6 +430,7 @@ ErrorCode ELFProcess::updateInfo() {
   _info.pid = _pid;
   _info.endian = (dataEndian == ELFDATA2MSB) ? kEndianBig : kEndianLittle;
   _info.pointerSize = is64Bit ? 8 : 4;
+  _archInfo = ProcessArchInfo(_info);
 
   //
   // Enumerate the Auxiliary Vector to extract UID, EUID, GID and EGID;
@@ -412,10 +470,12 @@ ErrorCode ELFProcess::updateInfo() {
 // successful, any other error should be ignored.
 //
 ErrorCode ELFProcess::updateAuxiliaryVector() {
-#if 0
-    if (!_auxiliaryVector.empty())
-        return kErrorAlreadyExist;
-#endif
+  //
+  // The auxiliary vector is set up by the kernel at exec time and never
+  // changes afterwards; it is cleared by afterExec.
+  //
+  if (!_auxiliaryVector.empty())
+    return kErrorAlreadyExist;
 
   return kSuccess;
 }
@@ -453,11 +513,6 @@ ErrorCode ELFProcess::enumerateAuxiliaryVector(
 //
 ErrorCode ELFProcess::getSharedLibraryInfoAddress(Address &address) {
   if (!_sharedLibraryInfoAddress.valid()) {
-    //
-    // Force the updating of process information.
-    //
-    _info.pid = -1;
-
     ErrorCode error = updateInfo();
     if (error != kSuccess && error != kErrorAlreadyExist)
       return error;
@@ -479,19 +534,371 @@ ErrorCode ELFProcess::getSharedLibraryInfoAddress(Address &address) {
 }
 
 //
-// Enumerates the linkmap of this SVR4 ELF process.
+// Enumerates the linkmap of this SVR4 ELF process. The list is kept between
+// calls and only refreshed when the dynamic linker reports a change through
+// the rendezvous breakpoint, or on every stop when that breakpoint could not
+// be set.
 //
 ErrorCode ELFProcess::enumerateSharedLibraries(
     std::function<void(SharedLibrary const &)> const &cb) {
+  if (!_sharedLibrariesValid) {
+    ErrorCode error = updateSharedLibraries(false);
+    if (error != kSuccess)
+      return error;
+  }
+
+  for (auto const &shlib : _sharedLibraries) {
+    cb(shlib);
+  }
+
+  return kSuccess;
+}
+
+//
+// Walks the link map and updates the cached library list. Entries that are
+// already known (same link map entry and name pointer) keep their path, so
+// only the names of new libraries are read. When appendOnly is set, the walk
+// starts from the last known entry, as the dynamic linker appends newly
+// loaded libraries to the end of the list.
+//
+ErrorCode ELFProcess::updateSharedLibraries(bool appendOnly) {
   Address address;
   ErrorCode error = getSharedLibraryInfoAddress(address);
   if (error != kSuccess)
     return error;
 
-  if (CPUTypeIs64Bit(_info.cpuType)) {
-    return EnumerateLinkMap<uint64_t>(this, address, cb);
-  } else {
-    return EnumerateLinkMap<uint32_t>(this, address, cb);
+  bool is64Bit = CPUTypeIs64Bit(_info.cpuType);
+
+  Rendezvous rendezvous;
+  error = is64Bit ? ReadRendezvous<uint64_t>(this, address, rendezvous)
+                  : ReadRendezvous<uint32_t>(this, address, rendezvous);
+  if (error != kSuccess)
+    return error;
+
+  std::map<uint64_t, SharedLibrary const *> known;
+  for (auto const &shlib : _sharedLibraries) {
+    known[shlib.svr4.mapAddress] = &shlib;
+  }
+
+  std::vector<SharedLibrary> libraries;
+  uint64_t linkMapAddress = rendezvous.mapAddress;
+  if (appendOnly && !_sharedLibraries.empty()) {
+    libraries.assign(_sharedLibraries.begin(), _sharedLibraries.end() - 1);
+    linkMapAddress = _sharedLibraries.back().svr4.mapAddress;
+  }
+
+  size_t nread = 0;
+  while (linkMapAddress != 0) {
+    if (libraries.size() >= kMaxLinkMapEntries)
+      return kErrorInvalidArgument;
+
+    SharedLibrary shlib;
+    uint64_t nextAddress;
+    error = is64Bit
+                ? ReadLinkMapEntry<uint64_t>(this, linkMapAddress, shlib,
+                                             nextAddress)
+                : ReadLinkMapEntry<uint32_t>(this, linkMapAddress, shlib,
+                                             nextAddress);
+    if (error != kSuccess)
+      return error;
+
+    shlib.main = libraries.empty();
+
+    auto it = known.find(linkMapAddress);
+    if (it != known.end() &&
+        it->second->svr4.nameAddress == shlib.svr4.nameAddress &&
+        it->second->svr4.baseAddress == shlib.svr4.baseAddress) {
+      shlib.path = it->second->path;
+    } else {
+      error = readString(shlib.svr4.nameAddress, shlib.path, PATH_MAX);
+      if (error != kSuccess)
+        return error;
+      nread++;
+    }
+
+    libraries.push_back(shlib);
+    linkMapAddress = nextAddress;
+  }
+
+  DS2LOG(Target, Debug, "%zu shared libraries, %zu new names read",
+         libraries.size(), nread);
+
+  _sharedLibraries.swap(libraries);
+  _sharedLibrariesValid = true;
+  return kSuccess;
+}
+
+//
+// The dynamic linker calls r_debug.r_brk before and after changing the
+// link map, with r_state set to RT_ADD or RT_DELETE and then RT_CONSISTENT.
+// Until r_debug is set up, the entry point of the program is used instead;
+// all the libraries it depends on are loaded by the time it runs.
+//
+void ELFProcess::armSharedLibraryBreakpoint() {
+  if (_sharedLibraryBreakpoint.valid() || _sharedLibraryTrackingUnsupported)
+    return;
+
+  BreakpointManager *bpm = breakpointManager();
+  if (bpm == nullptr)
+    return;
+
+  Address address;
+  ErrorCode error = getSharedLibraryInfoAddress(address);
+  if (error == kErrorUnsupported) {
+    // Static executable, there is nothing to track.
+    _sharedLibraryTrackingUnsupported = true;
+    return;
+  } else if (error != kSuccess) {
+    return;
+  }
+
+  Rendezvous rendezvous;
+  error = CPUTypeIs64Bit(_info.cpuType)
+              ? ReadRendezvous<uint64_t>(this, address, rendezvous)
+              : ReadRendezvous<uint32_t>(this, address, rendezvous);
+  if (error == kSuccess && rendezvous.brk != 0) {
+    uint64_t brk = rendezvous.brk;
+#if defined(ARCH_ARM)
+    brk &= ~1ULL;
+#endif
+    if (bpm->addInternal(brk) != kSuccess)
+      return;
+
+    DS2LOG(Target, Debug, "tracking shared libraries at %#llx",
+           (unsigned long long)brk);
+    _sharedLibraryBreakpoint = brk;
+
+    if (_entryBreakpoint.valid()) {
+      bpm->removeInternal(_entryBreakpoint);
+      _entryBreakpoint.clear();
+    }
+    return;
+  }
+
+  if (!_entryBreakpoint.valid() && _entryPoint.valid()) {
+    if (bpm->addInternal(_entryPoint) == kSuccess) {
+      _entryBreakpoint = _entryPoint;
+    }
+  }
+}
+
+//
+// A thread that stopped on an internal breakpoint is moved past it with the
+// breakpoint removed, so that resuming the thread doesn't hit it again.
+//
+void ELFProcess::stepOverInternalBreakpoint() {
+  BreakpointManager *bpm = breakpointManager();
+  Thread *thread = _currentThread;
+  Address site = _sharedLibraryBreakpoint;
+
+  if (bpm == nullptr || thread == nullptr || !site.valid())
+    return;
+
+  Architecture::CPUState state;
+  if (thread->readCPUState(state, Architecture::kRegisterSetGP) != kSuccess ||
+      state.pc() != site.value())
+    return;
+
+  bpm->removeInternal(site);
+
+  ErrorCode error = super::beforeResume();
+  if (error == kSuccess) {
+    error = thread->step();
+  }
+  if (error == kSuccess) {
+    error = wait();
+  }
+  if (error == kSuccess) {
+    error = super::afterResume();
+  }
+  if (error != kSuccess) {
+    DS2LOG(Target, Warning, "cannot step tid %llu over %#llx, error=%d",
+           (unsigned long long)thread->tid(),
+           (unsigned long long)site.value(), error);
+  }
+
+  bpm->addInternal(site);
+}
+
+ErrorCode ELFProcess::beforeResume() {
+  BreakpointManager *bpm = breakpointManager();
+
+  if (_internalStop) {
+    _internalStop = false;
+    stepOverInternalBreakpoint();
+  } else if (bpm != nullptr && _currentThread != nullptr &&
+             _sharedLibraryBreakpoint.valid()) {
+    //
+    // The debugger was told about a stop on the rendezvous breakpoint (e.g.
+    // it has a breakpoint there too) and decides how the thread resumes, so
+    // leave the breakpoint out until the next stop and walk the whole link
+    // map again then.
+    //
+    Architecture::CPUState state;
+    if (_currentThread->readCPUState(state, Architecture::kRegisterSetGP) ==
+            kSuccess &&
+        state.pc() == _sharedLibraryBreakpoint.value()) {
+      bpm->removeInternal(_sharedLibraryBreakpoint);
+      _sharedLibraryBreakpointDisarmed = true;
+    }
+  }
+
+  armSharedLibraryBreakpoint();
+
+  //
+  // Without the rendezvous breakpoint we can't know when the link map
+  // changes, so it has to be walked again after every stop.
+  //
+  if (!_sharedLibraryBreakpoint.valid() || _sharedLibraryBreakpointDisarmed) {
+    _sharedLibrariesValid = false;
+  }
+
+  return super::beforeResume();
+}
+
+ErrorCode ELFProcess::afterResume() {
+  BreakpointManager *bpm = breakpointManager();
+
+  //
+  // Check whether the debugger also has a breakpoint on our sites before
+  // super::afterResume() consumes its temporary breakpoints.
+  //
+  bool sharedLibraryInternal =
+      bpm != nullptr && bpm->isInternal(_sharedLibraryBreakpoint);
+  bool entryInternal = bpm != nullptr && bpm->isInternal(_entryBreakpoint);
+
+  ErrorCode error = super::afterResume();
+  if (error != kSuccess)
+    return error;
+
+  if (bpm == nullptr)
+    return kSuccess;
+
+  if (_sharedLibraryBreakpointDisarmed) {
+    bpm->addInternal(_sharedLibraryBreakpoint);
+    _sharedLibraryBreakpointDisarmed = false;
+    _sharedLibrariesValid = false;
+  }
+
+  //
+  // Only a thread that executed the breakpoint is on a rendezvous event; one
+  // that single-stepped onto the address (e.g. the debugger stepping into
+  // _dl_debug_state) hasn't run it yet.
+  //
+  Thread *thread = _currentThread;
+  if (thread == nullptr || !isAlive() || thread->state() != Thread::kStopped ||
+      thread->trapInfo().event != TrapInfo::kEventTrap ||
+      thread->trapInfo().signal != SIGTRAP || thread->singleStepping() ||
+      !hitBreakpoint(thread->tid()))
+    return kSuccess;
+
+  Architecture::CPUState state;
+  if (thread->readCPUState(state, Architecture::kRegisterSetGP) != kSuccess)
+    return kSuccess;
+
+  if (_sharedLibraryBreakpoint.valid() &&
+      state.pc() == _sharedLibraryBreakpoint.value()) {
+    handleSharedLibraryEvent();
+    _internalStop = sharedLibraryInternal;
+  } else if (_entryBreakpoint.valid() &&
+             state.pc() == _entryBreakpoint.value()) {
+    //
+    // The dynamic linker is done loading the initial libraries.
+    //
+    bpm->removeInternal(_entryBreakpoint);
+    _entryBreakpoint.clear();
+    _sharedLibrariesValid = false;
+    armSharedLibraryBreakpoint();
+    _internalStop = entryInternal;
+  }
+
+  return kSuccess;
+}
+
+bool ELFProcess::isInternalStop() const { return _internalStop; }
+
+void ELFProcess::handleSharedLibraryEvent() {
+  Address address;
+  if (getSharedLibraryInfoAddress(address) != kSuccess) {
+    _sharedLibrariesValid = false;
+    return;
+  }
+
+  Rendezvous rendezvous;
+  ErrorCode error = CPUTypeIs64Bit(_info.cpuType)
+                        ? ReadRendezvous<uint64_t>(this, address, rendezvous)
+                        : ReadRendezvous<uint32_t>(this, address, rendezvous);
+  if (error != kSuccess) {
+    _sharedLibrariesValid = false;
+    return;
+  }
+
+  DS2LOG(Target, Debug, "shared library event, state=%d", rendezvous.state);
+
+  switch (rendezvous.state) {
+  case kRendezvousAdd:
+    _sharedLibrariesAdded = true;
+    break;
+
+  case kRendezvousDelete:
+    _sharedLibrariesAdded = false;
+    break;
+
+  case kRendezvousConsistent:
+    //
+    // Only libraries that are loaded are appended, anything else needs a
+    // full walk (which still reuses the names we know).
+    //
+    if (_sharedLibrariesValid && _sharedLibrariesAdded) {
+      error = updateSharedLibraries(true);
+    } else {
+      error = updateSharedLibraries(false);
+    }
+    if (error != kSuccess) {
+      _sharedLibrariesValid = false;
+    }
+    _sharedLibrariesAdded = false;
+    break;
+  }
+}
+
+void ELFProcess::afterExec() {
+  //
+  // The new image has its own dynamic linker state; the breakpoints we had
+  // in the old one are gone with it.
+  //
+  BreakpointManager *bpm = breakpointManager();
+  if (bpm != nullptr) {
+    if (_sharedLibraryBreakpoint.valid() && !_sharedLibraryBreakpointDisarmed)
+      bpm->removeInternal(_sharedLibraryBreakpoint);
+    if (_entryBreakpoint.valid())
+      bpm->removeInternal(_entryBreakpoint);
+  }
+
+  _sharedLibraryInfoAddress.clear();
+  _sharedLibraries.clear();
+  _sharedLibrariesValid = false;
+  _sharedLibrariesAdded = false;
+  _sharedLibraryTrackingUnsupported = false;
+  _sharedLibraryBreakpoint.clear();
+  _entryBreakpoint.clear();
+  _sharedLibraryBreakpointDisarmed = false;
+  _internalStop = false;
+
+  //
+  // The process information describes the previous image, which may even
+  // have been of a different architecture; read it again from the new one.
+  //
+  _auxiliaryVector.clear();
+  _loadBase.clear();
+  _entryPoint.clear();
+  _info.clear();
+  _archInfo.clear();
+
+  ErrorCode error = updateInfo();
+  if (error != kSuccess && error != kErrorAlreadyExist) {
+    DS2LOG(Target, Error, "unable to read process info after exec, error=%d",
+           error);
   }
 }
 }
@@ -67,14 +67,7 @@ bool Process::isAlive() const { return (_pid > 0 && ::kill(_pid, 0) == 0); }
 ErrorCode Process::suspend() { return ptrace().suspend(_pid); }
 
 ErrorCode Process::resume(int signal, std::set<Thread *> const &excluded) {
-  ProcessInfo info;
-  ErrorCode error;
-
-  error = getInfo(info);
-  if (error != kSuccess)
-    return error;
-
-  return ptrace().resume(_pid, info, signal);
+  return ptrace().resume(_pid, _archInfo, signal);
 }
 
 ErrorCode Process::readMemory(Address const &address, void *data, size_t length,
@@ -84,6 +77,7 @@ ErrorCode Process::readMemory(Address const &address, void *data, size_t length,
 
 ErrorCode Process::writeMemory(Address const &address, void const *data,
                                size_t length, size_t *count) {
+  invalidateMemoryCache(address, length);
   return ptrace().writeMemory(_pid, address, data, length, count);
 }
 
@@ -12,16 +12,28 @@
 
 #include "DebugServer2/Architecture/CPUState.h"
 #include "DebugServer2/BreakpointManager.h"
+#include "DebugServer2/Host/Platform.h"
 #include "DebugServer2/Utils/Log.h"
 #include "DebugServer2/Target/ProcessBase.h"
 #include "DebugServer2/Target/Thread.h"
 
+#include <algorithm>
+#include <limits>
+
+using ds2::Host::Platform;
+
 namespace ds2 {
 namespace Target {
 
+//
+// Default amount of memory kept by the stop-scoped memory cache.
+//
+static size_t const kDefaultMemoryCacheBudget = 1024 * 1024;
+
 ProcessBase::ProcessBase()
     : _flags(0), _pid(kAnyProcessId), _loadBase(), _entryPoint(),
-      _currentThread(nullptr) {}
+      _currentThread(nullptr), _memoryCacheBudget(kDefaultMemoryCacheBudget),
+      _memoryCacheHits(0), _memoryCacheMisses(0) {}
 
 ProcessBase::~ProcessBase() {
   for (auto thread : _threads) {
@@ -54,6 +66,7 @@ void ProcessBase::cleanup() {
   }
   _threads.clear();
   _currentThread = nullptr;
+  invalidateMemoryCache();
 }
 
 ErrorCode ProcessBase::initialize(ProcessId pid, uint32_t flags) {
@@ -88,7 +101,6 @@ ProcessBase::enumerateThreads(std::function<void(Thread *)> const &cb) const {
     return kErrorProcessNotFound;
 
   for (auto const &it : _threads) {
-    static_cast<ThreadBase *>(it.second)->updateState();
     cb(it.second);
   }
 
@@ -107,6 +119,11 @@ ds2::Target::Thread *ProcessBase::thread(ThreadId tid) const {
   return (it == _threads.end()) ? nullptr : it->second;
 }
 
+//
+// Reads made through readMemoryBuffer are served from a page-granular cache
+// that is only valid while the inferior is stopped. On a miss, the pages
+// covering the whole request are read at once and kept for later requests.
+//
 ErrorCode ProcessBase::readMemoryBuffer(Address const &address, size_t length,
                                         std::string &buffer) {
   if (_pid == kAnyProcessId)
@@ -114,16 +131,180 @@ ErrorCode ProcessBase::readMemoryBuffer(Address const &address, size_t length,
   else if (!address.valid())
     return kErrorInvalidArgument;
 
-  buffer.resize(length);
+  uint64_t pageSize = Platform::GetPageSize();
+  uint64_t start = address.value() & ~(pageSize - 1);
+  uint64_t end = (address.value() + length + pageSize - 1) & ~(pageSize - 1);
+
+  if (length == 0 || end <= start || end - start > _memoryCacheBudget) {
+    buffer.resize(length);
+
+    size_t nread;
+    ErrorCode error = readMemory(address, &buffer[0], length, &nread);
+    if (error != kSuccess) {
+      buffer.clear();
+      return error;
+    }
+
+    buffer.resize(nread);
+    return kSuccess;
+  }
+
+  if (readMemoryCache(address, length, buffer)) {
+    _memoryCacheHits++;
+    return kSuccess;
+  }
+
+  _memoryCacheMisses++;
+
+  std::string pages;
+  pages.resize(end - start);
 
   size_t nread;
-  ErrorCode error = readMemory(address, &buffer[0], length, &nread);
+  ErrorCode error = readMemory(start, &pages[0], pages.size(), &nread);
+  if (error == kSuccess && nread <= address.value() - start) {
+    error = kErrorInvalidAddress;
+  }
   if (error != kSuccess) {
     buffer.clear();
     return error;
   }
 
-  buffer.resize(nread);
+  fillMemoryCache(start, pages, nread);
+
+  size_t offset = address.value() - start;
+  buffer.assign(pages, offset, std::min(length, nread - offset));
+  return kSuccess;
+}
+
+//
+// Reads a NUL-terminated string of at most `length' characters. The string
+// is read one page at a time, so that only the pages it actually spans are
+// touched and an unmapped page after the terminator doesn't fail the read.
+//
+ErrorCode ProcessBase::readString(Address const &address, std::string &str,
+                                  size_t length) {
+  if (_pid == kAnyProcessId)
+    return kErrorProcessNotFound;
+  else if (!address.valid())
+    return kErrorInvalidArgument;
+
+  uint64_t pageSize = Platform::GetPageSize();
+  uint64_t current = address.value();
+
+  str.clear();
+  while (str.length() < length) {
+    size_t chunkSize = pageSize - (current & (pageSize - 1));
+    chunkSize = std::min<size_t>(chunkSize, length - str.length());
+
+    std::string chunk;
+    ErrorCode error = readMemoryBuffer(current, chunkSize, chunk);
+    if (error != kSuccess)
+      return error;
+
+    size_t nul = chunk.find('\0');
+    if (nul != std::string::npos) {
+      str.append(chunk, 0, nul);
+      return kSuccess;
+    }
+
+    str += chunk;
+    if (chunk.length() < chunkSize)
+      return kErrorInvalidAddress;
+
+    current += chunkSize;
+  }
+
+  return kSuccess;
+}
+
+//
+// Reads several ranges at once. Ranges that share or touch pages are
+// coalesced into a single span that is read with one readMemoryBuffer call;
+// ranges that could not be fully served from their span (e.g. because an
+// unreadable page sits in the middle of it) are retried on their own so that
+// each one reports its own outcome.
+//
+ErrorCode ProcessBase::readMemoryRanges(MemoryRange::Collection &ranges) {
+  if (_pid == kAnyProcessId)
+    return kErrorProcessNotFound;
+
+  uint64_t pageSize = Platform::GetPageSize();
+
+  std::vector<size_t> order;
+  for (size_t n = 0; n < ranges.size(); n++) {
+    ranges[n].data.clear();
+    ranges[n].error =
+        ranges[n].start.valid() ? kSuccess : kErrorInvalidArgument;
+    if (ranges[n].error == kSuccess && ranges[n].length > 0) {
+      order.push_back(n);
+    }
+  }
+
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return ranges[a].start.value() < ranges[b].start.value();
+  });
+
+  size_t first = 0;
+  while (first < order.size()) {
+    uint64_t spanStart = ranges[order[first]].start.value();
+    uint64_t spanEnd = spanStart + ranges[order[first]].length;
+    size_t last = first + 1;
+
+    while (last < order.size()) {
+      MemoryRange const &range = ranges[order[last]];
+      uint64_t spanLastPage = (spanEnd - 1) & ~(pageSize - 1);
+      if ((range.start.value() & ~(pageSize - 1)) > spanLastPage + pageSize)
+        break;
+      spanEnd = std::max(spanEnd, range.start.value() + range.length);
+      last++;
+    }
+
+    std::string span;
+    ErrorCode error = readMemoryBuffer(spanStart, spanEnd - spanStart, span);
+
+    for (size_t n = first; n < last; n++) {
+      MemoryRange &range = ranges[order[n]];
+      uint64_t offset = range.start.value() - spanStart;
+
+      if (error == kSuccess && offset + range.length <= span.size()) {
+        range.data.assign(span, offset, range.length);
+      } else {
+        range.error = readMemoryBuffer(range.start, range.length, range.data);
+      }
+    }
+
+    first = last;
+  }
+
+  return kSuccess;
+}
+
+//
+// Walks the address space one region at a time; platforms that have the
+// whole map at hand override this. Holes are not reported.
+//
+ErrorCode ProcessBase::enumerateMemoryRegions(
+    std::function<void(MemoryRegionInfo const &)> const &cb) {
+  if (_pid == kAnyProcessId)
+    return kErrorProcessNotFound;
+
+  uint64_t address = 0;
+  for (;;) {
+    MemoryRegionInfo region;
+    ErrorCode error = getMemoryRegionInfo(address, region);
+    if (error != kSuccess)
+      return error;
+
+    if (region.protection != 0) {
+      cb(region);
+    }
+
+    uint64_t next = region.start.value() + region.length;
+    if (region.length == 0 || next <= address)
+      break;
+    address = next;
+  }
+
   return kSuccess;
 }
 
@@ -153,6 +334,86 @@ ErrorCode ProcessBase::writeMemoryBuffer(Address const &address,
   return writeMemory(address, &buffer[0], length, nwritten);
 }
 
+void ProcessBase::setMemoryCacheBudget(size_t budget) {
+  _memoryCacheBudget = budget;
+  invalidateMemoryCache();
+}
+
+bool ProcessBase::readMemoryCache(Address const &address, size_t length,
+                                  std::string &buffer) const {
+  uint64_t pageSize = Platform::GetPageSize();
+  uint64_t current = address.value();
+  uint64_t end = address.value() + length;
+
+  buffer.clear();
+  while (current < end) {
+    auto it = _memoryCache.find(current & ~(pageSize - 1));
+    if (it == _memoryCache.end()) {
+      buffer.clear();
+      return false;
+    }
+
+    size_t offset = current - it->first;
+    size_t ncopy = std::min<uint64_t>(pageSize - offset, end - current);
+    buffer.append(it->second, offset, ncopy);
+    current += ncopy;
+  }
+
+  return true;
+}
+
+void ProcessBase::fillMemoryCache(uint64_t address, std::string const &pages,
+                                  size_t length) {
+  uint64_t pageSize = Platform::GetPageSize();
+
+  //
+  // Only complete pages are cached; a trailing partial page means that the
+  // read stopped at an unreadable page.
+  //
+  for (size_t offset = 0; offset + pageSize <= length; offset += pageSize) {
+    auto result = _memoryCache.insert(
+        std::make_pair(address + offset, pages.substr(offset, pageSize)));
+    if (!result.second)
+      continue;
+    _memoryCacheOrder.push_back(address + offset);
+  }
+
+  while (!_memoryCacheOrder.empty() &&
+         _memoryCache.size() * pageSize > _memoryCacheBudget) {
+    _memoryCache.erase(_memoryCacheOrder.front());
+    _memoryCacheOrder.pop_front();
+  }
+}
+
+void ProcessBase::invalidateMemoryCache() {
+  _memoryCache.clear();
+  _memoryCacheOrder.clear();
+}
+
+void ProcessBase::invalidateMemoryCache(Address const &address,
+                                        size_t length) {
+  if (_memoryCache.empty() || length == 0)
+    return;
+
+  uint64_t pageSize = Platform::GetPageSize();
+  uint64_t start = address.value() & ~(pageSize - 1);
+  uint64_t end = address.value() + length;
+  if (end < start) {
+    end = std::numeric_limits<uint64_t>::max();
+  }
+
+  //
+  // The pages must leave the eviction order too, otherwise a page cached
+  // again later would be evicted as early as the one it replaced.
+  //
+  _memoryCache.erase(_memoryCache.lower_bound(start),
+                     _memoryCache.lower_bound(end));
+  auto covered = [&](uint64_t page) { return page >= start && page < end; };
+  _memoryCacheOrder.erase(std::remove_if(_memoryCacheOrder.begin(),
+                                         _memoryCacheOrder.end(), covered),
+                          _memoryCacheOrder.end());
+}
+
 void ProcessBase::insert(ThreadBase *thread) {
   if (!_threads.insert(std::make_pair(thread->tid(),
                                       static_cast<Thread *>(thread))).second)
@@ -184,6 +445,14 @@ ErrorCode ProcessBase::beforeResume() {
   if (!isAlive())
     return kErrorProcessNotFound;
 
+  //
+  // Anything cached during this stop may change once the inferior runs.
+  //
+  DS2LOG(Target, Debug, "memory cache: %llu hits, %llu misses",
+         (unsigned long long)_memoryCacheHits,
+         (unsigned long long)_memoryCacheMisses);
+  invalidateMemoryCache();
+
   BreakpointManager *bpm = breakpointManager();
 
   //
@@ -197,6 +466,8 @@ ErrorCode ProcessBase::beforeResume() {
 }
 
 ErrorCode ProcessBase::afterResume() {
+  _breakpointHits.clear();
+
   if (!isAlive())
     return kSuccess;
 
@@ -212,6 +483,7 @@ ErrorCode ProcessBase::afterResume() {
       if (bpm->hit(it.second)) {
         DS2LOG(Target, Info, "hit breakpoint for tid %llu",
                (unsigned long long)it.second->tid());
+        _breakpointHits.insert(it.second->tid());
       }
     }
   }
@@ -219,6 +491,12 @@ ErrorCode ProcessBase::afterResume() {
   return kSuccess;
 }
 
+//
+// Whether the last stop was caused by the debug server itself and should
+// not be reported to the debugger.
+//
+bool ProcessBase::isInternalStop() const { return false; }
+
 void ProcessBase::prepareForDetach() {
   BreakpointManager *bpm = breakpointManager();
   if (bpm != nullptr) {
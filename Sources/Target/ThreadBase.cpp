@@ -15,7 +15,7 @@ namespace ds2 {
 namespace Target {
 
 ThreadBase::ThreadBase(Process *process, ThreadId tid)
-    : _process(process), _tid(tid), _state(kInvalid) {
+    : _process(process), _tid(tid), _state(kInvalid), _singleStepping(false) {
   _process->insert(this);
 }
 
@@ -24,7 +24,5 @@ ThreadBase::~ThreadBase() {}
 ErrorCode ThreadBase::prepareSoftwareSingleStep(Address const &) {
   return kErrorUnsupported;
 }
-
-void ThreadBase::updateState() {}
 }
 }
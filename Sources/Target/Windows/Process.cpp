@@ -66,6 +66,8 @@ ErrorCode Process::updateInfo() {
   _info.osType = Platform::GetOSTypeName();
   _info.osVendor = Platform::GetOSVendorName();
 
+  _archInfo = ProcessArchInfo(_info);
+
   return kSuccess;
 }
 
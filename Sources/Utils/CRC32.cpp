@@ -0,0 +1,108 @@
+//
+// Copyright (c) 2014, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the University of Illinois/NCSA Open
+// Source License found in the LICENSE file in the root directory of this
+// source tree. An additional grant of patent rights can be found in the
+// PATENTS file in the same directory.
+//
+
+#include "DebugServer2/Utils/CRC32.h"
+
+#include <cstring>
+
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define DS2_CRC32_ARM64
+#endif
+
+namespace ds2 {
+
+#if defined(DS2_CRC32_ARM64)
+//
+// The ARMv8 CRC32 instructions implement the same polynomial, but in its
+// reflected form. Bit-reversing the state and every input byte turns one
+// into the other.
+//
+static uint32_t UpdateHardware(uint32_t crc, uint8_t const *bytes,
+                               size_t length) {
+  uint32_t state = __rbit(crc);
+
+  for (; length >= sizeof(uint64_t); bytes += sizeof(uint64_t),
+                                     length -= sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    state = __crc32d(state, __revll(__rbitll(word)));
+  }
+
+  for (; length > 0; bytes++, length--) {
+    state = __crc32b(state, __rbit(*bytes) >> 24);
+  }
+
+  return __rbit(state);
+}
+#else
+namespace {
+
+//
+// Slice-by-8 tables: table[k][n] is the CRC of byte n followed by k zero
+// bytes, which lets the kernel consume eight bytes per iteration.
+//
+struct SliceBy8Tables {
+  uint32_t table[8][256];
+
+  SliceBy8Tables() {
+    for (uint32_t n = 0; n < 256; n++) {
+      uint32_t crc = n << 24;
+      for (int bit = 0; bit < 8; bit++) {
+        crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04c11db7 : (crc << 1);
+      }
+      table[0][n] = crc;
+    }
+
+    for (int k = 1; k < 8; k++) {
+      for (uint32_t n = 0; n < 256; n++) {
+        uint32_t crc = table[k - 1][n];
+        table[k][n] = (crc << 8) ^ table[0][crc >> 24];
+      }
+    }
+  }
+};
+}
+
+static inline uint32_t LoadBigEndian32(uint8_t const *bytes) {
+  return (static_cast<uint32_t>(bytes[0]) << 24) |
+         (static_cast<uint32_t>(bytes[1]) << 16) |
+         (static_cast<uint32_t>(bytes[2]) << 8) | static_cast<uint32_t>(bytes[3]);
+}
+
+static uint32_t UpdateSliceBy8(uint32_t crc, uint8_t const *bytes,
+                               size_t length) {
+  static SliceBy8Tables const tables;
+  uint32_t const(*t)[256] = tables.table;
+
+  for (; length >= 8; bytes += 8, length -= 8) {
+    uint32_t high = crc ^ LoadBigEndian32(bytes);
+    uint32_t low = LoadBigEndian32(bytes + 4);
+    crc = t[7][high >> 24] ^ t[6][(high >> 16) & 0xff] ^
+          t[5][(high >> 8) & 0xff] ^ t[4][high & 0xff] ^ t[3][low >> 24] ^
+          t[2][(low >> 16) & 0xff] ^ t[1][(low >> 8) & 0xff] ^ t[0][low & 0xff];
+  }
+
+  for (; length > 0; bytes++, length--) {
+    crc = (crc << 8) ^ t[0][((crc >> 24) ^ *bytes) & 0xff];
+  }
+
+  return crc;
+}
+#endif
+
+uint32_t UpdateGDBCRC32(uint32_t crc, void const *data, size_t length) {
+#if defined(DS2_CRC32_ARM64)
+  return UpdateHardware(crc, static_cast<uint8_t const *>(data), length);
+#else
+  return UpdateSliceBy8(crc, static_cast<uint8_t const *>(data), length);
+#endif
+}
+}
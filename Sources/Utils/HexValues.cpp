@@ -0,0 +1,209 @@
+//
+// Copyright (c) 2014, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the University of Illinois/NCSA Open
+// Source License found in the LICENSE file in the root directory of this
+// source tree. An additional grant of patent rights can be found in the
+// PATENTS file in the same directory.
+//
+
+#include "DebugServer2/Utils/HexValues.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define DS2_HEX_SSE2
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__GNUC__)
+#include <arm_neon.h>
+#define DS2_HEX_NEON
+#endif
+
+namespace ds2 {
+
+//
+// Returns the value of a hex digit, or -1 if ch is not one.
+//
+static inline int HexDigitValue(char ch) {
+  if (ch >= '0' && ch <= '9')
+    return ch - '0';
+  else if (ch >= 'a' && ch <= 'f')
+    return ch - 'a' + 10;
+  else if (ch >= 'A' && ch <= 'F')
+    return ch - 'A' + 10;
+  return -1;
+}
+
+#if defined(DS2_HEX_SSE2)
+static inline __m128i NibblesToHex(__m128i nibbles) {
+  //
+  // '0' + n, plus the distance between '9' + 1 and 'a' for n > 9.
+  //
+  __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)),
+                                  _mm_set1_epi8('a' - '0' - 10));
+  return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+}
+
+static inline __m128i HexToNibbles(__m128i chars, __m128i &valid) {
+  //
+  // Characters above 0x7f compare as negative and are therefore rejected by
+  // both range checks.
+  //
+  __m128i digits = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)),
+                                 _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1)));
+  __m128i lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+  __m128i letters =
+      _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                    _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+  valid = _mm_and_si128(valid, _mm_or_si128(digits, letters));
+  return _mm_or_si128(
+      _mm_and_si128(digits, _mm_sub_epi8(chars, _mm_set1_epi8('0'))),
+      _mm_andnot_si128(digits,
+                       _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+}
+
+//
+// Merges the nibbles of digit pairs: each 16-bit lane holds the high digit
+// in its low byte and the low digit in its high byte.
+//
+static inline __m128i MergeNibbles(__m128i nibbles) {
+  return _mm_or_si128(_mm_and_si128(_mm_slli_epi16(nibbles, 4),
+                                    _mm_set1_epi16(0xf0)),
+                      _mm_srli_epi16(nibbles, 8));
+}
+#elif defined(DS2_HEX_NEON)
+static inline uint8x16_t NibblesToHex(uint8x16_t nibbles) {
+  uint8x16_t letters = vandq_u8(vcgtq_u8(nibbles, vdupq_n_u8(9)),
+                                vdupq_n_u8('a' - '0' - 10));
+  return vaddq_u8(vaddq_u8(nibbles, vdupq_n_u8('0')), letters);
+}
+
+static inline uint8x16_t HexToNibbles(uint8x16_t chars, uint8x16_t &valid) {
+  uint8x16_t digits = vandq_u8(vcgeq_u8(chars, vdupq_n_u8('0')),
+                               vcleq_u8(chars, vdupq_n_u8('9')));
+  uint8x16_t lower = vorrq_u8(chars, vdupq_n_u8(0x20));
+  uint8x16_t letters = vandq_u8(vcgeq_u8(lower, vdupq_n_u8('a')),
+                                vcleq_u8(lower, vdupq_n_u8('f')));
+  valid = vandq_u8(valid, vorrq_u8(digits, letters));
+  return vbslq_u8(digits, vsubq_u8(chars, vdupq_n_u8('0')),
+                  vsubq_u8(lower, vdupq_n_u8('a' - 10)));
+}
+
+static inline bool AllSet(uint8x16_t mask) {
+  uint64x2_t lanes = vreinterpretq_u64_u8(mask);
+  return (vgetq_lane_u64(lanes, 0) & vgetq_lane_u64(lanes, 1)) == ~0ULL;
+}
+#endif
+
+void EncodeHex(char *output, void const *data, size_t length) {
+  uint8_t const *input = static_cast<uint8_t const *>(data);
+  size_t n = 0;
+
+#if defined(DS2_HEX_SSE2)
+  for (; n + 16 <= length; n += 16) {
+    __m128i bytes =
+        _mm_loadu_si128(reinterpret_cast<__m128i const *>(input + n));
+    __m128i high = NibblesToHex(
+        _mm_and_si128(_mm_srli_epi16(bytes, 4), _mm_set1_epi8(0x0f)));
+    __m128i low = NibblesToHex(_mm_and_si128(bytes, _mm_set1_epi8(0x0f)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + 2 * n),
+                     _mm_unpacklo_epi8(high, low));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + 2 * n + 16),
+                     _mm_unpackhi_epi8(high, low));
+  }
+#elif defined(DS2_HEX_NEON)
+  for (; n + 16 <= length; n += 16) {
+    uint8x16_t bytes = vld1q_u8(input + n);
+    uint8x16x2_t digits;
+    digits.val[0] = NibblesToHex(vshrq_n_u8(bytes, 4));
+    digits.val[1] = NibblesToHex(vandq_u8(bytes, vdupq_n_u8(0x0f)));
+    vst2q_u8(reinterpret_cast<uint8_t *>(output + 2 * n), digits);
+  }
+#endif
+
+  for (; n < length; n++) {
+    output[2 * n] = NibbleToHex(input[n] >> 4);
+    output[2 * n + 1] = NibbleToHex(input[n] & 15);
+  }
+}
+
+bool DecodeHex(void *data, char const *input, size_t length) {
+  uint8_t *output = static_cast<uint8_t *>(data);
+  size_t n = 0;
+
+  DS2ASSERT(length % 2 == 0);
+  length /= 2;
+
+#if defined(DS2_HEX_SSE2)
+  __m128i valid = _mm_set1_epi8(-1);
+  for (; n + 16 <= length; n += 16) {
+    __m128i first = HexToNibbles(
+        _mm_loadu_si128(reinterpret_cast<__m128i const *>(input + 2 * n)),
+        valid);
+    __m128i second = HexToNibbles(
+        _mm_loadu_si128(reinterpret_cast<__m128i const *>(input + 2 * n + 16)),
+        valid);
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(output + n),
+        _mm_packus_epi16(MergeNibbles(first), MergeNibbles(second)));
+  }
+  if (_mm_movemask_epi8(valid) != 0xffff)
+    return false;
+#elif defined(DS2_HEX_NEON)
+  uint8x16_t valid = vdupq_n_u8(0xff);
+  for (; n + 16 <= length; n += 16) {
+    uint8x16x2_t chars =
+        vld2q_u8(reinterpret_cast<uint8_t const *>(input + 2 * n));
+    uint8x16_t high = HexToNibbles(chars.val[0], valid);
+    uint8x16_t low = HexToNibbles(chars.val[1], valid);
+    vst1q_u8(output + n, vorrq_u8(vshlq_n_u8(high, 4), low));
+  }
+  if (!AllSet(valid))
+    return false;
+#endif
+
+  for (; n < length; n++) {
+    int high = HexDigitValue(input[2 * n]);
+    int low = HexDigitValue(input[2 * n + 1]);
+    if (high < 0 || low < 0)
+      return false;
+    output[n] = static_cast<uint8_t>((high << 4) | low);
+  }
+
+  return true;
+}
+
+uint8_t SumBytes(void const *data, size_t length) {
+  uint8_t const *input = static_cast<uint8_t const *>(data);
+  uint8_t sum = 0;
+  size_t n = 0;
+
+  //
+  // Per-lane byte additions wrap modulo 256 just like the final sum, so the
+  // lanes only need to be added together once at the end.
+  //
+#if defined(DS2_HEX_SSE2)
+  __m128i sums = _mm_setzero_si128();
+  for (; n + 16 <= length; n += 16) {
+    sums = _mm_add_epi8(
+        sums, _mm_loadu_si128(reinterpret_cast<__m128i const *>(input + n)));
+  }
+  sums = _mm_sad_epu8(sums, _mm_setzero_si128());
+  sum = static_cast<uint8_t>(_mm_cvtsi128_si32(sums) +
+                             _mm_cvtsi128_si32(_mm_srli_si128(sums, 8)));
+#elif defined(DS2_HEX_NEON)
+  uint8x16_t sums = vdupq_n_u8(0);
+  for (; n + 16 <= length; n += 16) {
+    sums = vaddq_u8(sums, vld1q_u8(input + n));
+  }
+  uint64x2_t lanes = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(sums)));
+  sum = static_cast<uint8_t>(vgetq_lane_u64(lanes, 0) +
+                             vgetq_lane_u64(lanes, 1));
+#endif
+
+  for (; n < length; n++) {
+    sum += input[n];
+  }
+
+  return sum;
+}
+}
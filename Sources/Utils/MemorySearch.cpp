@@ -0,0 +1,114 @@
+//
+// Copyright (c) 2014, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the University of Illinois/NCSA Open
+// Source License found in the LICENSE file in the root directory of this
+// source tree. An additional grant of patent rights can be found in the
+// PATENTS file in the same directory.
+//
+
+#include "DebugServer2/Utils/MemorySearch.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define DS2_SEARCH_SSE2
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__GNUC__)
+#include <arm_neon.h>
+#define DS2_SEARCH_NEON
+#endif
+
+namespace ds2 {
+
+static uint8_t const *SearchScalar(uint8_t const *haystack,
+                                   size_t haystackLength,
+                                   uint8_t const *needle, size_t needleLength) {
+  if (haystackLength < needleLength)
+    return nullptr;
+
+  uint8_t const *end = haystack + (haystackLength - needleLength) + 1;
+  for (uint8_t const *ptr = haystack; ptr < end; ptr++) {
+    ptr = static_cast<uint8_t const *>(std::memchr(ptr, needle[0], end - ptr));
+    if (ptr == nullptr)
+      return nullptr;
+    if (std::memcmp(ptr + 1, needle + 1, needleLength - 1) == 0)
+      return ptr;
+  }
+
+  return nullptr;
+}
+
+#if defined(DS2_SEARCH_SSE2) || defined(DS2_SEARCH_NEON)
+//
+// Compares 16 candidate positions at a time: a position is only verified
+// with memcmp when both the first and the last byte of the needle match.
+//
+static uint8_t const *SearchVector(uint8_t const *haystack,
+                                   size_t haystackLength,
+                                   uint8_t const *needle, size_t needleLength) {
+  size_t const last = needleLength - 1;
+  size_t offset = 0;
+
+#if defined(DS2_SEARCH_SSE2)
+  __m128i const firstBytes = _mm_set1_epi8(needle[0]);
+  __m128i const lastBytes = _mm_set1_epi8(needle[last]);
+#else
+  uint8x16_t const firstBytes = vdupq_n_u8(needle[0]);
+  uint8x16_t const lastBytes = vdupq_n_u8(needle[last]);
+#endif
+
+  for (; offset + last + 16 <= haystackLength; offset += 16) {
+#if defined(DS2_SEARCH_SSE2)
+    __m128i first = _mm_cmpeq_epi8(
+        firstBytes, _mm_loadu_si128(reinterpret_cast<__m128i const *>(
+                        haystack + offset)));
+    __m128i final = _mm_cmpeq_epi8(
+        lastBytes, _mm_loadu_si128(reinterpret_cast<__m128i const *>(
+                       haystack + offset + last)));
+    uint64_t mask = _mm_movemask_epi8(_mm_and_si128(first, final));
+    unsigned const shift = 0;
+#else
+    uint8x16_t both =
+        vandq_u8(vceqq_u8(firstBytes, vld1q_u8(haystack + offset)),
+                 vceqq_u8(lastBytes, vld1q_u8(haystack + offset + last)));
+    //
+    // Narrow every byte of the compare result to a nibble so that the
+    // whole vector fits in a 64-bit mask.
+    //
+    uint64_t mask = vget_lane_u64(
+        vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(both), 4)), 0);
+    mask &= 0x8888888888888888ULL;
+    unsigned const shift = 2;
+#endif
+
+    while (mask != 0) {
+      size_t position = offset + (__builtin_ctzll(mask) >> shift);
+      if (needleLength <= 2 || std::memcmp(haystack + position + 1,
+                                           needle + 1, needleLength - 2) == 0)
+        return haystack + position;
+      mask &= mask - 1;
+    }
+  }
+
+  return SearchScalar(haystack + offset, haystackLength - offset, needle,
+                      needleLength);
+}
+#endif
+
+void const *SearchMemory(void const *haystack, size_t haystackLength,
+                         void const *needle, size_t needleLength) {
+  if (needleLength == 0)
+    return haystack;
+
+#if defined(DS2_SEARCH_SSE2) || defined(DS2_SEARCH_NEON)
+  return SearchVector(static_cast<uint8_t const *>(haystack), haystackLength,
+                      static_cast<uint8_t const *>(needle), needleLength);
+#else
+  return SearchScalar(static_cast<uint8_t const *>(haystack), haystackLength,
+                      static_cast<uint8_t const *>(needle), needleLength);
+#endif
+}
+}
@@ -0,0 +1,109 @@
+//
+// Copyright (c) 2014, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the University of Illinois/NCSA Open
+// Source License found in the LICENSE file in the root directory of this
+// source tree. An additional grant of patent rights can be found in the
+// PATENTS file in the same directory.
+//
+
+#include "DebugServer2/Utils/CRC32.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using ds2::UpdateGDBCRC32;
+using ds2::kGDBCRC32Initial;
+
+//
+// Byte at a time reference, with the usual single 256-entry table.
+//
+static uint32_t UpdateBytewise(uint32_t crc, uint8_t const *bytes,
+                               size_t length) {
+  static uint32_t table[256];
+  if (table[1] == 0) {
+    for (uint32_t n = 0; n < 256; n++) {
+      uint32_t value = n << 24;
+      for (int bit = 0; bit < 8; bit++) {
+        value = (value & 0x80000000) ? (value << 1) ^ 0x04c11db7 : (value << 1);
+      }
+      table[n] = value;
+    }
+  }
+
+  for (; length > 0; bytes++, length--) {
+    crc = (crc << 8) ^ table[((crc >> 24) ^ *bytes) & 0xff];
+  }
+  return crc;
+}
+
+template <typename Function>
+static double MeasureMBps(Function const &function, size_t length) {
+  size_t const total = 256 << 20;
+  size_t iterations = total / length;
+  uint32_t sink = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t n = 0; n < iterations; n++) {
+    sink ^= function();
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  // Keeps the loop from being optimized out.
+  if (sink == 0x12345678) {
+    printf("\n");
+  }
+  return (iterations * length) / elapsed.count() / (1 << 20);
+}
+
+int main() {
+  std::vector<uint8_t> data((1 << 20) + 16);
+  srand(0);
+  for (auto &byte : data) {
+    byte = rand() & 0xff;
+  }
+
+  //
+  // The kernel must give the same CRC as the reference whatever the
+  // alignment of the first and last bytes.
+  //
+  int failures = 0;
+  for (size_t head = 0; head < 16; head++) {
+    for (size_t length = 0; length < 300; length++) {
+      uint32_t expected =
+          UpdateBytewise(kGDBCRC32Initial, &data[head], length);
+      uint32_t result = UpdateGDBCRC32(kGDBCRC32Initial, &data[head], length);
+      if (result != expected) {
+        printf("head %zu length %zu: %08x != %08x\n", head, length, result,
+               expected);
+        failures++;
+      }
+    }
+  }
+  if (UpdateGDBCRC32(kGDBCRC32Initial, &data[3], 1 << 20) !=
+      UpdateBytewise(kGDBCRC32Initial, &data[3], 1 << 20)) {
+    printf("1 MiB: mismatch\n");
+    failures++;
+  }
+  printf("failures=%d\n", failures);
+  if (failures != 0)
+    return 1;
+
+  static size_t const sizes[] = {64, 4 << 10, 64 << 10, 1 << 20};
+  printf("%10s %14s %14s\n", "size", "kernel MB/s", "bytewise MB/s");
+  for (size_t length : sizes) {
+    double kernel = MeasureMBps(
+        [&] { return UpdateGDBCRC32(kGDBCRC32Initial, &data[1], length); },
+        length);
+    double bytewise = MeasureMBps(
+        [&] { return UpdateBytewise(kGDBCRC32Initial, &data[1], length); },
+        length);
+    printf("%10zu %14.0f %14.0f\n", length, kernel, bytewise);
+  }
+
+  return 0;
+}
@@ -0,0 +1,162 @@
+//
+// Copyright (c) 2014, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the University of Illinois/NCSA Open
+// Source License found in the LICENSE file in the root directory of this
+// source tree. An additional grant of patent rights can be found in the
+// PATENTS file in the same directory.
+//
+
+#include "DebugServer2/Utils/HexValues.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using ds2::DecodeHex;
+using ds2::EncodeHex;
+using ds2::SumBytes;
+
+//
+// Scalar versions of the kernels, as used for the tails and on targets
+// without SSE2 or NEON.
+//
+static void EncodeHexScalar(char *output, uint8_t const *input,
+                            size_t length) {
+  for (size_t n = 0; n < length; n++) {
+    output[2 * n] = ds2::NibbleToHex(input[n] >> 4);
+    output[2 * n + 1] = ds2::NibbleToHex(input[n] & 15);
+  }
+}
+
+static int HexDigitValue(char ch) {
+  if (ch >= '0' && ch <= '9')
+    return ch - '0';
+  if (ch >= 'a' && ch <= 'f')
+    return ch - 'a' + 10;
+  if (ch >= 'A' && ch <= 'F')
+    return ch - 'A' + 10;
+  return -1;
+}
+
+static bool DecodeHexScalar(uint8_t *output, char const *input,
+                            size_t length) {
+  for (size_t n = 0; n < length / 2; n++) {
+    int high = HexDigitValue(input[2 * n]);
+    int low = HexDigitValue(input[2 * n + 1]);
+    if (high < 0 || low < 0)
+      return false;
+    output[n] = static_cast<uint8_t>((high << 4) | low);
+  }
+  return true;
+}
+
+static uint8_t SumBytesScalar(uint8_t const *input, size_t length) {
+  uint8_t sum = 0;
+  for (size_t n = 0; n < length; n++) {
+    sum += input[n];
+  }
+  return sum;
+}
+
+template <typename Function>
+static double MeasureMBps(Function const &function, size_t length) {
+  size_t const total = 256 << 20;
+  size_t iterations = total / length;
+  unsigned sink = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t n = 0; n < iterations; n++) {
+    sink += function();
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  // Keeps the loop from being optimized out.
+  if (sink == 0x12345678) {
+    printf("\n");
+  }
+  return (iterations * length) / elapsed.count() / (1 << 20);
+}
+
+int main() {
+  static size_t const kMaxLength = 64 << 10;
+  std::vector<uint8_t> data(kMaxLength + 16), decoded(kMaxLength + 16);
+  std::vector<char> hex(2 * kMaxLength + 32), expected(2 * kMaxLength + 32);
+  srand(0);
+  for (auto &byte : data) {
+    byte = rand() & 0xff;
+  }
+
+  //
+  // The kernels must agree with the scalar code whatever the alignment and
+  // length, and catch a bad digit wherever it is.
+  //
+  int failures = 0;
+  for (size_t head = 0; head < 16; head++) {
+    for (size_t length = 0; length < 100; length++) {
+      EncodeHex(&hex[head], &data[head], length);
+      EncodeHexScalar(&expected[0], &data[head], length);
+      if (!std::equal(&expected[0], &expected[2 * length], &hex[head]))
+        failures++;
+
+      if (!DecodeHex(&decoded[0], &hex[head], 2 * length) ||
+          !std::equal(&data[head], &data[head + length], &decoded[0]))
+        failures++;
+
+      if (SumBytes(&data[head], length) !=
+          SumBytesScalar(&data[head], length))
+        failures++;
+
+      for (size_t bad = 0; bad < 2 * length; bad++) {
+        char saved = hex[head + bad];
+        hex[head + bad] = "g/:@G`\xff"[bad % 7];
+        if (DecodeHex(&decoded[0], &hex[head], 2 * length))
+          failures++;
+        hex[head + bad] = saved;
+      }
+    }
+  }
+  printf("failures=%d\n", failures);
+  if (failures != 0)
+    return 1;
+
+  //
+  // Throughput is counted in input bytes for the decoder and in data bytes
+  // for the encoder and the checksum.
+  //
+  static size_t const sizes[] = {64, 4 << 10, 64 << 10};
+  printf("%8s %10s %10s %10s %10s %10s %10s\n", "size", "encode", "scalar",
+         "decode", "scalar", "checksum", "scalar");
+  for (size_t length : sizes) {
+    EncodeHex(&hex[0], &data[0], length);
+    printf(
+        "%8zu %10.0f %10.0f %10.0f %10.0f %10.0f %10.0f\n", length,
+        MeasureMBps(
+            [&] {
+              EncodeHex(&hex[0], &data[0], length);
+              return hex[length];
+            },
+            length),
+        MeasureMBps(
+            [&] {
+              EncodeHexScalar(&hex[0], &data[0], length);
+              return hex[length];
+            },
+            length),
+        MeasureMBps([&] { return DecodeHex(&decoded[0], &hex[0], length); },
+                    length),
+        MeasureMBps(
+            [&] { return DecodeHexScalar(&decoded[0], &hex[0], length); },
+            length),
+        MeasureMBps([&] { return SumBytes(&data[0], length); }, length),
+        MeasureMBps([&] { return SumBytesScalar(&data[0], length); },
+                    length));
+  }
+  printf("(MB/s)\n");
+
+  return 0;
+}
@@ -0,0 +1,81 @@
+//
+// Copyright (c) 2014, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the University of Illinois/NCSA Open
+// Source License found in the LICENSE file in the root directory of this
+// source tree. An additional grant of patent rights can be found in the
+// PATENTS file in the same directory.
+//
+
+#include "DebugServer2/BreakpointManager.h"
+
+#include <cstdio>
+#include <set>
+
+using ds2::Address;
+using ds2::BreakpointManager;
+
+//
+// Keeps track of which locations are armed instead of patching a process.
+//
+struct DummyBreakpointManager : BreakpointManager {
+  std::set<uint64_t> armed;
+
+  DummyBreakpointManager() : BreakpointManager(nullptr) { enable(); }
+
+  virtual bool hit(ds2::Target::Thread *) { return false; }
+  virtual void enableLocation(Site const &site) {
+    armed.insert(site.address);
+  }
+  virtual void disableLocation(Site const &site) {
+    armed.erase(site.address);
+  }
+};
+
+static int failures = 0;
+
+static void check(char const *name, bool result) {
+  if (!result) {
+    printf("%s: failed\n", name);
+    failures++;
+  }
+}
+
+int main() {
+  static uint64_t const kRendezvous = 0x1000;
+
+  //
+  // A client breakpoint placed on the r_debug breakpoint must not take the
+  // internal one with it when removed, whatever its type.
+  //
+  BreakpointManager::Type const types[] = {
+      BreakpointManager::kTypePermanent,
+      BreakpointManager::kTypeTemporaryOneShot,
+      BreakpointManager::kTypeTemporaryUntilHit};
+
+  for (auto type : types) {
+    DummyBreakpointManager bpm;
+    bpm.addInternal(kRendezvous);
+    bpm.add(kRendezvous, type, 1);
+    check("client remove", bpm.remove(kRendezvous) == ds2::kSuccess);
+    check("still internal", bpm.isInternal(kRendezvous));
+    check("still armed", bpm.armed.count(kRendezvous) == 1);
+    check("second remove", bpm.remove(kRendezvous) == ds2::kErrorNotFound);
+    check("internal remove", bpm.removeInternal(kRendezvous) == ds2::kSuccess);
+    check("disarmed", bpm.armed.empty() && !bpm.has(kRendezvous));
+  }
+
+  //
+  // Without an internal breakpoint, removing the client one clears the site.
+  //
+  for (auto type : types) {
+    DummyBreakpointManager bpm;
+    bpm.add(kRendezvous, type, 1);
+    check("plain remove", bpm.remove(kRendezvous) == ds2::kSuccess);
+    check("plain disarmed", bpm.armed.empty() && !bpm.has(kRendezvous));
+  }
+
+  printf("failures=%d\n", failures);
+  return failures != 0;
+}